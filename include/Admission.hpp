@@ -0,0 +1,98 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Admission.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef ADMISSION_HPP
+#define ADMISSION_HPP
+
+#include <string>
+#include <map>
+#include <ctime>
+#include <vector>
+#include <netinet/in.h>
+
+#include "Mutex.hpp"
+
+struct GlobalConfig;
+
+/*
+Overload detector of one event loop, after CoDel: the time a pass over the
+ready events takes is how long the last of them waited. A burst is fine, but
+once every pass stayed above shed_target for a whole shed_interval the queue
+is standing and new requests get the preformatted 503 until a pass is fast
+again. Owned by the loop, no locking.
+*/
+class LoadShedder {
+  private:
+    long    _target; //microseconds, 0 never sheds
+    long    _interval;
+    long    _firstAbove; //when a pass above target since then turns shedding on, 0 when below
+    bool    _shedding;
+
+  public:
+    LoadShedder(int targetMs, int intervalMs);
+
+    void    record(long started, long finished);
+    bool    shedding() const;
+};
+
+/*
+What admit() recorded for one fd, so release() undoes exactly that.
+*/
+struct Admitted {
+  bool      admitted;
+  bool      counted; //in _perIp, limit_conn_per_ip was on when it was admitted
+  in_addr_t ip;
+
+  Admitted();
+};
+
+/*
+worker_connections and limit_conn_per_ip for the whole process, checked when
+a connection is accepted (by the single loop or by the reactors' acceptor)
+and released when the ClientConnection goes away, on whichever thread.
+Connections over a limit get the 503 right away and are closed.
+Admitted fds are indexed by the fd itself, like ConnectionTable, and the
+per-address counts are only kept while limit_conn_per_ip is set.
+*/
+class AdmissionControl {
+  private:
+    size_t                    _maxConnections; //0 is unlimited
+    int                       _maxPerIp; //0 is unlimited
+    int                       _shedTarget; //ms, handed to each loop's LoadShedder
+    int                       _shedInterval;
+    size_t                    _active;
+    std::map<in_addr_t, int>  _perIp;
+    std::vector<Admitted>     _byFd; //admitted fds, released before they are closed
+    Mutex                     _lock;
+
+    AdmissionControl(const AdmissionControl& other);
+    AdmissionControl& operator=(const AdmissionControl& other);
+
+  public:
+    AdmissionControl();
+
+    void    configure(const GlobalConfig& global);
+    bool    admit(int fd, in_addr_t ip);
+    void    release(int fd);
+    size_t  active();
+    int     shedTarget() const;
+    int     shedInterval() const;
+};
+
+extern AdmissionControl g_admission;
+
+long				monotonicMicros();
+time_t				monotonicSeconds();
+const std::string&	unavailableResponse();
+void				rejectConnection(int fd);
+
+#endif // ADMISSION_HPP
@@ -0,0 +1,48 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ByteRange.hpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef BYTERANGE_HPP
+#define BYTERANGE_HPP
+
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+class ClientConnection;
+
+/*
+One satisfiable range of a file, both ends inclusive like in Content-Range.
+*/
+struct ByteRange {
+  off_t first;
+  off_t last;
+
+  ByteRange(off_t first, off_t last);
+  off_t length() const;
+};
+
+/*
+IGNORED means the Range header is absent, malformed or asks for too much and
+the whole file is sent with 200, as RFC 9110 allows.
+*/
+enum RangeResult {
+  RANGE_IGNORED,
+  RANGE_SATISFIABLE,
+  RANGE_NOT_SATISFIABLE
+};
+
+RangeResult parseRangeHeader(const std::string& header, off_t fileSize, std::vector<ByteRange>& ranges);
+bool        queueByteRanges(ClientConnection& client, int fileFd, off_t fileSize,
+              const std::string& contentType, const std::vector<ByteRange>& ranges,
+              const std::string& extraHeaders);
+
+#endif // BYTERANGE_HPP
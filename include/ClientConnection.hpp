@@ -14,28 +14,131 @@
 #define CLIENTCONNECTION_HPP
 
 #include <string>
+#include <vector>
+#include <deque>
+#include <ctime>
+#include <sys/types.h>
+#include <netinet/in.h>
 
+#include "TimerWheel.hpp"
 
+class MultipartParser;
+class Request;
+class VirtualHosts;
+class ConfigSnapshot;
+struct GzipPolicy;
+
+/*
+Where the incremental parser is in the request at the front of _buffer.
+*/
 enum ClientState {
   READING_HEADERS,
   READING_BODY,
-  REQUEST_COMPLETE
+  REQUEST_COMPLETE,
+  HEADERS_TOO_LARGE //over client_max_header_size, a 431 is queued and nothing more is read
+};
+
+/*
+What the connection's timer is currently waiting for.
+*/
+enum TimerKind {
+  TIMER_NONE,
+  TIMER_HEADER, //client_header_timeout
+  TIMER_BODY, //client_body_timeout
+  TIMER_SEND, //send_timeout
+  TIMER_IDLE //keepalive_timeout
+};
+
+/*
+One piece of queued output: bytes in memory, or a range of an open file that
+is handed to sendfile() so it never passes through user space.
+*/
+struct OutputChunk {
+  std::string data;
+  int         fileFd; //-1 for in-memory data, otherwise owned by the chunk
+  off_t       offset; //next byte to send, in data or in the file
+  size_t      remaining; //file bytes left to send
+
+  OutputChunk();
 };
 
 class ClientConnection {
   private:
     int               _fd;
+    sockaddr_in       _peer; //the client's address, as accept() reported it
     std::vector<char> _buffer;
+    ClientState       _state;
+    size_t            _scanOffset; //where the search for the end of headers resumes
+    size_t            _headerEnd; //offset of the first body byte once headers are in
+    size_t            _contentLength; //parsed once, when the headers are complete
+    MultipartParser*  _upload; //set when the body is streamed to disk instead of buffered
+    size_t            _bodyStreamed; //body bytes already handed to _upload
+    bool              _limited; //over limit_req, the body is dropped and the request gets a 429
+    bool              _peerClosed; //recv() returned 0
+    bool              _moreToRead; //stopped at a complete request, the socket may hold more
+    std::deque<OutputChunk> _output; //responses waiting for the socket to drain
+    bool              _wantWrite; //registered for write events
+    bool              _keepAlive; //keep the connection once the response is out
+    int               _keepAliveTimeout; //seconds to wait for the next request
+    int               _requestCount; //requests served on this connection
+    bool              _idle; //waiting for the next request on a keep-alive connection
+    const GzipPolicy* _gzip; //set while a request that accepts gzip is handled, NULL otherwise
+    ConfigSnapshot*   _snapshot; //the configuration we serve from, we hold a reference
+    const VirtualHosts* _hosts; //the server blocks of the socket we were accepted on, in _snapshot
+    const ServerConfig* _config; //picked by Host once the headers are in, the default one before
+    TimerWheel*       _timers; //the wheel of the event loop that owns us
+    TimerHandle       _timer;
+    TimerKind         _timerKind;
 
   public:
-    ClientConnection(int fd);
+    ClientConnection(int fd, const sockaddr_in& peer, ConfigSnapshot* snapshot, const VirtualHosts& hosts,
+      TimerWheel& timers);
     ~ClientConnection();
 
-    std::string	getRawRequest() const;
     int         getFd() const;
+    in_addr_t   peerIp() const;
+    std::string peerAddress() const;
+    int         peerPort() const;
+    bool        peerClosed() const;
+    bool        moreToRead() const;
     void        closeConnection();
+    ClientState getState() const;
     bool        isRequestComplete() const;
-    int        recvFullRequest(int client_fd, const ServerConfig& config);
+    size_t      requestLength() const;
+    size_t      contentLength() const;
+    const char* requestData() const;
+    void        consumeRequest();
+    MultipartParser* getUpload() const;
+    bool        rateLimited() const;
+    int        recvFullRequest(int client_fd);
+    const ServerConfig& config() const;
+
+    void        queueOutput(const std::string& data);
+    void        queueFile(int fileFd, off_t offset, size_t length);
+    bool        hasPendingOutput() const;
+    int         flushOutput();
+    bool        wantsWrite() const;
+    void        setWantWrite(bool wantWrite);
+
+    bool        keepAlive() const;
+    void        setKeepAlive(bool keepAlive, int timeout);
+    int         countRequest();
+    void        resetRequest();
+    void        clearIdle();
+    void        updateTimer(time_t now);
+    const char* timerName() const;
+
+    const GzipPolicy* gzip() const;
+    void        setGzip(const GzipPolicy* gzip);
+
+  private:
+    void        advanceParser();
+    void        followReload();
+    void        rejectHeaders();
+    bool        overRequestLimit(const Request& head) const;
+    void        parseHeaderFields();
+    void        streamBody();
+    void        popOutput();
 };
 
 #endif // CLIENTCONNECTION_HPP
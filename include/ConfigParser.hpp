@@ -17,8 +17,10 @@
 #include <string>
 
 #include "LocationConfig.hpp"
+#include "GlobalConfig.hpp"
 
 class ServerConfig;
+class RewriteEngine;
 class LocationConfig;
 
 class ConfigParser {
@@ -26,17 +28,24 @@ public:
   ConfigParser();
   ~ConfigParser();
   const std::vector<ServerConfig>& getServers() const;
+  const GlobalConfig& getGlobal() const;
   void	parseFile(const std::string& path);
   void	parseServerBlock(std::ifstream& file, ServerConfig& server);
   void	parseLocationBlock(std::ifstream& file, LocationConfig& location);
+  void  parseGlobalDirective(const std::string& key, const std::string& value);
   void  parseServerDirective(ServerConfig& server, const std::string& key, const std::string& value);
   void	parseLocationDirective(LocationConfig& location, const std::string& key, const std::string& value);
+  bool  parseGzip(GzipPolicy& policy, const std::string& key, const std::string& value);
+  bool  parseRewrite(RewriteEngine& rewrites, const std::string& key, const std::string& value);
+  bool  parseLimitReq(LimitReqPolicy& policy, const std::string& key, const std::string& value);
+  bool  parseOpenFileCache(FileCachePolicy& policy, const std::string& key, const std::string& value);
   void	applyInheritance(LocationConfig& location, const ServerConfig& server);
   void	error(const std::string& msg) const;
   void  print() const;
 
   private:
   std::vector<ServerConfig> servers;
+  GlobalConfig              global;
 
 };
 
@@ -0,0 +1,95 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ConfigSnapshot.hpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef CONFIGSNAPSHOT_HPP
+#define CONFIGSNAPSHOT_HPP
+
+#include <string>
+#include <map>
+
+#include "ConfigParser.hpp"
+#include "ServerConfig.hpp"
+#include "VirtualHosts.hpp"
+#include "Mutex.hpp"
+
+/*
+One host:port to listen on, and the server blocks that share it.
+*/
+struct ListenAddress {
+  std::string   host;
+  int           port;
+  ListenOptions options; //from whichever block spelled them out, checkDuplicateHostPortPairs() made them agree
+  VirtualHosts  hosts;
+
+  ListenAddress();
+};
+
+/*
+One parsed configuration file, never modified once built. It is reference
+counted: the store holds one reference, and so does every connection that
+serves from it. After a reload, the old snapshot lives on until its last
+connection has moved on to the new one or closed.
+*/
+class ConfigSnapshot {
+  private:
+    ConfigParser                          _parser;
+    std::map<std::string, ListenAddress>  _addresses; //by "host:port"
+    unsigned                              _generation; //1 at startup, +1 per reload
+    int                                   _refs;
+    Mutex                                 _lock; //guards _refs, connections of every reactor share it
+
+    ConfigSnapshot(const ConfigSnapshot& other);
+    ConfigSnapshot& operator=(const ConfigSnapshot& other);
+    ~ConfigSnapshot();
+
+  public:
+    ConfigSnapshot(const ConfigParser& parser, unsigned generation);
+
+    void                retain();
+    void                release();
+    const GlobalConfig& global() const;
+    const std::map<std::string, ListenAddress>& addresses() const;
+    const VirtualHosts* hosts(const std::string& address) const;
+    unsigned            generation() const;
+};
+
+/*
+The configuration new requests are served from, replaced on SIGHUP by the
+thread that owns the listeners. Every other thread only takes references.
+*/
+class ConfigStore {
+  private:
+    ConfigSnapshot* _current;
+    std::string     _path; //re-read on every reload
+    bool            _reusePort; //workers open new listeners with SO_REUSEPORT too
+    Mutex           _lock;
+
+    ConfigStore(const ConfigStore& other);
+    ConfigStore& operator=(const ConfigStore& other);
+
+  public:
+    ConfigStore();
+    ~ConfigStore();
+
+    void            setSource(const std::string& path);
+    const std::string& path() const;
+    void            setReusePort(bool reusePort);
+    bool            reusePort() const;
+    void            publish(ConfigSnapshot* snapshot);
+    ConfigSnapshot* acquire();
+    ConfigSnapshot* acquireIfNewer(const ConfigSnapshot* mine);
+    void            clear();
+};
+
+extern ConfigStore g_configs;
+
+#endif // CONFIGSNAPSHOT_HPP
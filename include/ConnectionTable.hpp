@@ -0,0 +1,85 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ConnectionTable.hpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef CONNECTIONTABLE_HPP
+#define CONNECTIONTABLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <netinet/in.h>
+
+class ServerSocket;
+class ClientConnection;
+class VirtualHosts;
+class TimerWheel;
+class ConfigSnapshot;
+
+/*
+What an fd watched by an event loop is, so a ready event is dispatched with
+one array index instead of a lookup per kind.
+*/
+enum FdKind {
+  FD_NONE,
+  FD_LISTENER,
+  FD_CLIENT,
+  FD_WAKEUP //a reactor's wake-up pipe
+};
+
+struct FdSlot {
+  FdKind            kind;
+  ServerSocket*     listener; //set for FD_LISTENER
+  ClientConnection* client; //set for FD_CLIENT
+};
+
+/*
+Every fd of one event loop, indexed by the fd itself: the kernel hands out
+the lowest free numbers, so the array stays about as long as the number of
+open fds and only grows when a new highest fd shows up.
+ClientConnections live in a slab: chunks of CHUNK objects allocated once and
+never given back, with a free list of the slots they left. Accepting a
+connection constructs it in place, closing one destroys it and pushes the
+slot back, the steady state does no allocation for connection objects.
+One per event loop (the single one, or each reactor), no locking.
+*/
+class ConnectionTable {
+  private:
+    static const size_t CHUNK = 256;
+
+    std::vector<FdSlot> _byFd;
+    std::vector<void*>  _chunks; //raw storage, CHUNK connections each
+    std::vector<void*>  _free; //unused slots, the last one freed is reused first while still in cache
+    size_t              _clients;
+
+    ConnectionTable(const ConnectionTable& other);
+    ConnectionTable& operator=(const ConnectionTable& other);
+
+    FdSlot& slot(int fd);
+    void    refill();
+
+  public:
+    ConnectionTable();
+    ~ConnectionTable();
+
+    const FdSlot&     operator[](int fd) const;
+    void              addListener(int fd, ServerSocket* listener);
+    void              addWakeup(int fd);
+    void              remove(int fd);
+    ClientConnection* createClient(int fd, const sockaddr_in& peer, ConfigSnapshot* snapshot,
+                        const VirtualHosts& hosts, TimerWheel& timers);
+    void              listeners(std::vector<ServerSocket*>& out) const;
+    void              destroyClient(int fd);
+    ClientConnection* client(int fd) const;
+    size_t            clientCount() const;
+    void              destroyClients();
+};
+
+#endif // CONNECTIONTABLE_HPP
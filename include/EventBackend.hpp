@@ -0,0 +1,96 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventBackend.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef EVENTBACKEND_HPP
+#define EVENTBACKEND_HPP
+
+#include <vector>
+#include <string>
+#include <poll.h>
+#include <sys/epoll.h>
+
+/*
+ * Readiness flags shared by every backend. EVENT_EDGE is only meaningful when
+ * registering: epoll uses it for EPOLLET, poll() is always level-triggered.
+ */
+enum EventFlags {
+  EVENT_READ = 0x1,
+  EVENT_WRITE = 0x2,
+  EVENT_ERROR = 0x4,
+  EVENT_EDGE = 0x8
+};
+
+struct IoEvent {
+  int fd;
+  int flags;
+};
+
+/*
+ * The event loop talks to the kernel through this interface so it does not care
+ * whether it runs on epoll or poll. Adding and removing an fd is O(1) in both.
+ */
+class EventBackend {
+  public:
+    virtual ~EventBackend() {}
+
+    virtual bool        add(int fd, int flags) = 0;
+    virtual bool        modify(int fd, int flags) = 0;
+    virtual void        remove(int fd) = 0;
+    virtual int         wait(std::vector<IoEvent>& ready, int timeoutMs) = 0;
+    virtual const char* name() const = 0;
+
+    static EventBackend* create(const std::string& preferred);
+};
+
+/*
+ * epoll reactor: wait() only returns the fds that are ready, so the cost of
+ * one wakeup scales with activity instead of with the number of connections.
+ */
+class EpollBackend : public EventBackend {
+  private:
+    int                             _epfd;
+    std::vector<struct epoll_event> _events;
+
+    EpollBackend(const EpollBackend& other);
+    EpollBackend& operator=(const EpollBackend& other);
+  public:
+    EpollBackend();
+    ~EpollBackend();
+
+    bool        isValid() const;
+    bool        add(int fd, int flags);
+    bool        modify(int fd, int flags);
+    void        remove(int fd);
+    int         wait(std::vector<IoEvent>& ready, int timeoutMs);
+    const char* name() const;
+};
+
+/*
+ * poll() fallback. The pollfd array stays dense: _index maps an fd to its slot
+ * and removal swaps the last entry into the hole instead of erasing.
+ */
+class PollBackend : public EventBackend {
+  private:
+    std::vector<struct pollfd> _fds;
+    std::vector<int>           _index;
+  public:
+    PollBackend();
+    ~PollBackend();
+
+    bool        add(int fd, int flags);
+    bool        modify(int fd, int flags);
+    void        remove(int fd);
+    int         wait(std::vector<IoEvent>& ready, int timeoutMs);
+    const char* name() const;
+};
+
+#endif // EVENTBACKEND_HPP
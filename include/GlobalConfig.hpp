@@ -0,0 +1,44 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   GlobalConfig.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef GLOBALCONFIG_HPP
+#define GLOBALCONFIG_HPP
+
+#include <string>
+#include <map>
+
+#include "RateLimiter.hpp"
+
+/*
+Directives that live outside of any server block (e.g. inside 'events {}')
+and apply to the whole process.
+*/
+struct	GlobalConfig {
+	std::map<std::string, std::string> raw; //stores unprocessed directives
+	std::string	event_backend; //"epoll" (default) or "poll"
+	size_t		static_cache_size; //byte budget of the static response cache, 0 disables it
+	size_t		static_cache_max_file; //largest file kept in that cache
+	size_t		gzip_cache_size; //byte budget for gzipped static responses, 0 compresses every time
+	int			worker_processes; //forked event loops, 1 serves everything from this process
+	int			worker_threads; //reactor threads per process, 1 keeps the single event loop
+	bool		least_conn; //hand connections to the least loaded reactor instead of in turn
+	size_t		worker_connections; //open client connections per process, 0 is unlimited
+	int			limit_conn_per_ip; //open connections from one address, 0 is unlimited
+	int			shed_target; //ms an event loop pass may take before requests are shed, 0 never sheds
+	int			shed_interval; //ms the loop must stay over shed_target first
+	std::map<std::string, LimitReqZoneSpec> limit_req_zones; //limit_req_zone tables by name
+
+	GlobalConfig();
+	void	print() const;
+};
+
+#endif // GLOBALCONFIG_HPP
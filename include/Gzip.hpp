@@ -0,0 +1,37 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Gzip.hpp                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef GZIP_HPP
+#define GZIP_HPP
+
+#include <string>
+#include <vector>
+
+/*
+Settings of the gzip* directives, set per server and per location. Bodies are
+only compressed when the client sends 'Accept-Encoding: gzip'.
+*/
+struct GzipPolicy {
+  bool                      enabled;
+  int                       level; //1 (fast) to 9 (small)
+  size_t                    minLength; //smaller bodies are not worth the header
+  size_t                    maxLength; //larger static files are sent as they are
+  std::vector<std::string>  types; //MIME types to compress, "*" for all
+
+  GzipPolicy();
+  bool  matchesType(const std::string& contentType) const;
+  bool  applies(const std::string& contentType, size_t size) const;
+};
+
+bool  gzipCompress(const char* data, size_t size, int level, std::string& out);
+
+#endif // GZIP_HPP
@@ -14,11 +14,9 @@
 #define HTTPSTATUS_HPP
 
 #include <string>
-#include <map>
 
 class HttpStatus {
   public:
-    static const std::map<int, std::string>& statusMessages();
 	static std::string getStatusMessages(int code);
 };
 
@@ -18,10 +18,15 @@
 #include <map>
 #include <vector>
 
+#include "OpenFileCache.hpp"
+#include "Gzip.hpp"
+#include "RateLimiter.hpp"
+
 struct	LocationConfig {
 	//raw is for testing, ensure we process everything (remove before finishing)
 	std::map<std::string, std::string> raw;//stores unprocessed directives
-	std::string	path;// URL path (e.g. /updload)
+	std::string	path;// URL path (e.g. /updload), or the pattern of a regex location
+	std::string	modifier; //"" prefix, "=" exact, "^~" prefix without regex, "~" / "~*" regex
 	std::string	root; // root directory for this location
 	int	returnStatusCode; //return error code if provided
 	std::vector<std::string> methods; // allowed http methods
@@ -30,6 +35,12 @@ struct	LocationConfig {
 	std::string	upload_path; //where uploaded files are stored
 	std::map<std::string, std::string> cgi_paths; // map ext -> CGI binary
 	bool	autoindex; //enable directory listing
+	bool	gzip_static; //send path.gz when the client accepts gzip
+	bool	brotli_static; //send path.br when the client accepts br
+	FileCachePolicy	open_file_cache; //starts from the server's settings
+	GzipPolicy	gzip; //on-the-fly compression, also starts from the server's settings
+	LimitReqPolicy	limit_req; //request rate per client address, also starts from the server's
+	std::vector<std::pair<std::string, std::string> > overrides; //this block's own lines for the three above
 	bool	root_set; //track override
 	bool	index_set; //track override
 
@@ -0,0 +1,70 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LocationRouter.hpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef LOCATIONROUTER_HPP
+#define LOCATIONROUTER_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <regex.h>
+
+struct LocationConfig;
+
+/*
+The server's location blocks compiled once, after parsing, into:
+- a sorted table of exact ('location = /path') matches,
+- a trie of path segments for prefix locations, so the longest prefix is found
+  in one walk down the request path whatever the number of locations,
+- the regex locations ('~', '~*') in config order.
+Precedence follows nginx: exact, then a '^~' prefix, then the first matching
+regex, then the longest prefix. Routes hold indexes into the server's
+locations vector, so a copied ServerConfig keeps routing to its own copies.
+*/
+class LocationRouter {
+  private:
+    typedef std::vector<std::pair<std::string, size_t> > Table;
+
+    struct Node {
+      Table children; //segment -> node index, sorted by segment
+      int   location; //prefix location ending here, -1 if none
+      bool  stopRegex; //that location was declared with '^~'
+
+      Node();
+    };
+
+    struct RegexRoute {
+      std::string pattern;
+      bool        icase;
+      size_t      location;
+      regex_t*    compiled;
+    };
+
+    Table                   _exact; //full path -> location index, sorted by path
+    std::vector<Node>       _nodes; //_nodes[0] is the root, i.e. 'location /'
+    std::vector<RegexRoute> _regexes;
+
+    size_t  addChild(size_t node, const std::string& segment);
+    void    compileRegexes();
+    void    freeRegexes();
+
+  public:
+    LocationRouter();
+    LocationRouter(const LocationRouter& other);
+    LocationRouter& operator=(const LocationRouter& other);
+    ~LocationRouter();
+
+    void                  build(const std::vector<LocationConfig>& locations);
+    const LocationConfig* match(const std::string& path, const std::vector<LocationConfig>& locations) const;
+};
+
+#endif // LOCATIONROUTER_HPP
@@ -0,0 +1,72 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MultipartParser.hpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef MULTIPARTPARSER_HPP
+#define MULTIPARTPARSER_HPP
+
+#include <string>
+
+/*
+Streaming multipart/form-data parser. The request body is fed in pieces as it
+comes off the socket and the first file part is written to a temporary file in
+the upload directory, so memory stays bounded by one read plus the boundary
+length no matter how large the upload is. The temporary file only replaces the
+destination once the whole body checked out: a failed or aborted upload leaves
+an existing file as it was, and a GET never sees half an upload.
+*/
+class MultipartParser {
+  private:
+    enum State {
+      PREAMBLE,     //before the first boundary
+      AFTER_BOUNDARY, //"\r\n" starts a part, "--" ends the body
+      PART_HEADERS,
+      PART_BODY,
+      EPILOGUE,     //after the closing boundary, ignored
+      FAILED
+    };
+
+    State         _state;
+    std::string   _delimiter; //"\r\n--" + boundary
+    std::string   _window; //bytes not yet processed, never much more than one read
+    std::string   _uploadDir;
+    size_t        _maxFileSize;
+    std::string   _filename;
+    std::string   _filePath; //the destination
+    std::string   _tempPath; //what we write to, renamed to _filePath by finish()
+    int           _fd; //of _tempPath, -1 when closed
+    bool          _inFilePart; //current part is the file we are saving
+    bool          _saved; //file part closed cleanly
+    size_t        _fileSize;
+    int           _errorStatus;
+
+    MultipartParser(const MultipartParser& other);
+    MultipartParser& operator=(const MultipartParser& other);
+
+    bool    parsePartHeaders(const std::string& headers);
+    bool    writeFileData(const char* data, size_t size);
+    void    closeFile();
+    void    fail(int status, const std::string& reason);
+    void    discardTemp();
+
+  public:
+    MultipartParser(const std::string& boundary, const std::string& uploadDir, size_t maxFileSize);
+    ~MultipartParser();
+
+    void                feed(const char* data, size_t size);
+    bool                finish();
+    int                 errorStatus() const;
+    const std::string&  filename() const;
+    const std::string&  path() const;
+    size_t              fileSize() const;
+};
+
+#endif // MULTIPARTPARSER_HPP
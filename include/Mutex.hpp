@@ -0,0 +1,53 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Mutex.hpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef MUTEX_HPP
+#define MUTEX_HPP
+
+#include <pthread.h>
+
+/*
+pthread mutex for the state the reactor threads share (the file and response
+caches, the try_files probes, a reactor's inbox). Uncontended it costs about
+as much as the function call, so the single-threaded server keeps it too.
+*/
+class Mutex {
+  private:
+    pthread_mutex_t _mutex;
+
+    Mutex(const Mutex& other);
+    Mutex& operator=(const Mutex& other);
+
+  public:
+    Mutex();
+    ~Mutex();
+
+    void    lock();
+    void    unlock();
+};
+
+/*
+Holds the mutex for the rest of the scope, every return path unlocks it.
+*/
+class ScopedLock {
+  private:
+    Mutex&  _mutex;
+
+    ScopedLock(const ScopedLock& other);
+    ScopedLock& operator=(const ScopedLock& other);
+
+  public:
+    explicit ScopedLock(Mutex& mutex);
+    ~ScopedLock();
+};
+
+#endif // MUTEX_HPP
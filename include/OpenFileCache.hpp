@@ -0,0 +1,99 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OpenFileCache.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef OPENFILECACHE_HPP
+#define OPENFILECACHE_HPP
+
+#include <string>
+#include <map>
+#include <list>
+#include <ctime>
+#include <sys/types.h>
+
+#include "Mutex.hpp"
+
+/*
+Settings of the open_file_cache* directives, set per server and per location.
+max == 0 means the cache is off and every lookup goes to the filesystem.
+*/
+struct FileCachePolicy {
+  size_t  max; //entries kept before the least recently used one is dropped
+  int     inactive; //seconds an unused entry survives
+  int     valid; //seconds before an entry is checked against the disk again
+  bool    errors; //also remember paths that do not exist
+
+  FileCachePolicy();
+};
+
+/*
+What the static handlers need to know about a path.
+*/
+struct FileInfo {
+  bool    exists;
+  bool    isDir;
+  off_t   size;
+  time_t  mtime;
+  ino_t   ino;
+
+  FileInfo();
+};
+
+/*
+Cache of open file descriptors and stat() results keyed by resolved path, like
+nginx's open_file_cache. A hot file costs no open() or stat() on repeat hits:
+the cached fd is dup()ed for the output queue, which owns and closes the copy.
+Entries are re-stat()ed once 'valid' has passed, dropped after 'inactive'
+seconds without a hit, and evicted least recently used beyond 'max'.
+One cache serves every reactor thread, each public call holds the lock.
+*/
+class OpenFileCache {
+  private:
+    struct Entry {
+      FileInfo  info;
+      int       fd; //-1 unless a regular file we could open
+      dev_t     dev;
+      time_t    checkedAt; //last time the entry was compared with the disk
+      time_t    lastUsed;
+      int       valid;
+      int       inactive;
+      std::list<std::string>::iterator lru;
+
+      Entry() : fd(-1), dev(0), checkedAt(0), lastUsed(0), valid(0), inactive(0) {}
+    };
+
+    std::map<std::string, Entry> _entries;
+    std::list<std::string>       _lru; //most recently used first
+    Mutex                        _lock;
+
+    OpenFileCache(const OpenFileCache& other);
+    OpenFileCache& operator=(const OpenFileCache& other);
+
+    Entry*  lookup(const std::string& path, const FileCachePolicy& policy, Entry& scratch, bool wantFd);
+    bool    load(const std::string& path, Entry& entry, bool wantFd);
+    bool    unchanged(const std::string& path, const Entry& entry) const;
+    void    release(Entry& entry);
+    void    erase(std::map<std::string, Entry>::iterator it);
+
+  public:
+    OpenFileCache();
+    ~OpenFileCache();
+
+    bool    stat(const std::string& path, const FileCachePolicy& policy, FileInfo& info);
+    int     open(const std::string& path, const FileCachePolicy& policy, FileInfo& info);
+    void    invalidate(const std::string& path);
+    void    expire(time_t now);
+    void    clear();
+};
+
+extern OpenFileCache g_openFileCache;
+
+#endif // OPENFILECACHE_HPP
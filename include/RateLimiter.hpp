@@ -0,0 +1,101 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RateLimiter.hpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef RATELIMITER_HPP
+#define RATELIMITER_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <netinet/in.h>
+
+#include "Mutex.hpp"
+
+/*
+limit_req_zone zone=name:size rate=Nr/s (or r/m), outside of the server blocks.
+*/
+struct LimitReqZoneSpec {
+  size_t  size; //bytes for the table, like nginx's zone size
+  long    rate; //thousandths of a request per second, so 1r/m keeps some precision
+
+  LimitReqZoneSpec();
+};
+
+/*
+limit_req zone=name burst=N, set per server and per location. Requests over
+the rate are answered with 429 right away, as with nginx's nodelay.
+*/
+struct LimitReqPolicy {
+  std::string zone; //empty when the location is not limited
+  int         burst; //requests a client may run ahead of the rate
+
+  LimitReqPolicy();
+};
+
+/*
+One token bucket per client address, in a fixed table sized once from the
+zone size: no allocation per client, however many there are. Open addressing
+with a window of PROBES slots from the hashed address; a new address takes a
+free slot of its window, or recycles the least recently seen one. A client
+idle long enough to be recycled had a full bucket anyway, so recycling only
+forgets clients that lost nothing. Shared by the reactor threads.
+*/
+class RateLimitZone {
+  private:
+    static const size_t PROBES = 8;
+
+    struct Bucket {
+      in_addr_t ip;
+      long      tokens; //millionths of a request
+      long      seen; //ms of the last request, 0 for a free slot
+    };
+
+    std::vector<Bucket> _table;
+    size_t              _mask;
+    long                _rate;
+    Mutex               _lock;
+
+    RateLimitZone(const RateLimitZone& other);
+    RateLimitZone& operator=(const RateLimitZone& other);
+
+  public:
+    RateLimitZone(const LimitReqZoneSpec& spec);
+
+    bool    allow(in_addr_t ip, int burst, long now);
+    void    setRate(long rate);
+    size_t  slots() const;
+};
+
+/*
+The limit_req_zone tables by name. A reload only adds zones or changes their
+rate: a table is never freed while a reactor may be counting in it.
+*/
+class RequestLimiter {
+  private:
+    std::map<std::string, RateLimitZone*> _zones;
+    Mutex                                 _lock; //guards _zones, not the tables
+
+    RequestLimiter(const RequestLimiter& other);
+    RequestLimiter& operator=(const RequestLimiter& other);
+
+  public:
+    RequestLimiter();
+    ~RequestLimiter();
+
+    void    configure(const std::map<std::string, LimitReqZoneSpec>& zones);
+    bool    enabled();
+    bool    allow(const LimitReqPolicy& policy, in_addr_t ip);
+};
+
+extern RequestLimiter g_requestLimiter;
+
+#endif // RATELIMITER_HPP
@@ -0,0 +1,80 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Reactor.hpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <pthread.h>
+#include <netinet/in.h>
+
+#include "Mutex.hpp"
+
+class EventBackend;
+class ClientConnection;
+class ServerSocket;
+class VirtualHosts;
+class TimerWheel;
+class ConnectionTable;
+class ConfigSnapshot;
+struct GlobalConfig;
+
+/*
+worker_threads N: the main thread only accepts, N reactor threads serve.
+Each reactor runs runEventLoop() on its own EventBackend and its own
+ConnectionTable, so a connection lives and dies on one thread and
+needs no locking. The acceptor drops new fds in a reactor's inbox and writes
+a byte to its wake-up pipe, the reactor then adopts them on its next wakeup.
+Only the caches, shared by all reactors, take locks.
+*/
+class Reactor {
+  private:
+    struct Handoff {
+      int                 fd;
+      sockaddr_in         peer;
+      ConfigSnapshot*     snapshot; //a reference taken by the acceptor, the connection inherits it
+      const VirtualHosts* hosts;
+    };
+
+    std::string           _backend; //"epoll" or "poll", like the single-threaded loop
+    pthread_t             _thread;
+    bool                  _started;
+    int                   _wake[2]; //the acceptor writes to [1], the reactor polls [0]
+    Mutex                 _lock; //guards _inbox and _connections
+    std::vector<Handoff>  _inbox;
+    size_t                _connections; //what the reactor holds, plus what it was handed since
+
+    Reactor(const Reactor& other);
+    Reactor& operator=(const Reactor& other);
+
+    static void*  run(void* self);
+    void          loop();
+
+  public:
+    Reactor(const std::string& backend);
+    ~Reactor();
+
+    bool    start();
+    void    stop();
+    void    handOff(int fd, const sockaddr_in& peer, ConfigSnapshot* snapshot, const VirtualHosts& hosts);
+    size_t  connections();
+
+    int     wakeFd() const;
+    void    adopt(EventBackend& events, ConnectionTable& table, TimerWheel& timers);
+    void    publish(size_t connections);
+};
+
+bool	runReactors(EventBackend& events, ConnectionTable& listeners, const GlobalConfig& global);
+
+#endif // REACTOR_HPP
@@ -16,32 +16,55 @@
 #include <string>
 #include <map>
 
+/*
+ * A view into the connection's receive buffer: a pointer and a length.
+ * Nothing is copied until str() is called.
+ */
+struct StringSlice {
+	const char*	data;
+	size_t		size;
+
+	StringSlice();
+	StringSlice(const char* data, size_t size);
+	std::string	str() const;
+	bool		empty() const;
+};
 
 /*
  * The Request class parses raw HTTP request strings.
  * It extracts the method and requested path (e.g., GET /index.html).
+ * All fields are slices of the buffer the request was read into, so that buffer
+ * must outlive the Request. Headers are only split into a map when asked for.
  */
 class Request {
 	public:
-		Request(const std::string& raw);
+		Request(const char* raw, size_t size);
 		std::string getRawRequest() const;
 		std::string getMethod() const;
 		std::string getPath() const;
 		std::string getBody() const;
+		const char*	getBodyData() const;
+		size_t		getBodySize() const;
 		std::string getQuery() const;
+		std::string getVersion() const;
 //    std::string getTarget() const;
+		std::string getHeader(const std::string& name) const;
 		const std::map<std::string, std::string>& getHeaders() const;
 	private:
-		std::string _method;
-		std::string _target; //the original request URI (e.g. "/cgi-bin/hello.py?name=Bob")
-		std::string _path; //path only (e.g. "/cgi-bin/hello.py")
-		std::string _query; //query only (e.g. "name=Bob")
-		std::string _version;
-		std::string _raw;
-		std::map<std::string, std::string> _headers;
+		const char*	_raw;
+		size_t		_size;
+		StringSlice	_method;
+		StringSlice	_target; //the original request URI (e.g. "/cgi-bin/hello.py?name=Bob")
+		StringSlice	_path; //path only (e.g. "/cgi-bin/hello.py")
+		StringSlice	_query; //query only (e.g. "name=Bob")
+		StringSlice	_version;
+		StringSlice	_headerBlock; //header lines, without the request line
+		StringSlice	_body;
+		mutable std::map<std::string, std::string> _headers;
+		mutable bool _headersParsed;
 
-		void parse(const std::string& raw);
-		void parseHeaders(const std::string& HeaderBlock);
+		void parse();
+		void parseHeaders() const;
 };
 
-#endif // REQUEST_HPP
\ No newline at end of file
+#endif // REQUEST_HPP
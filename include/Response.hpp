@@ -14,6 +14,7 @@
 #define RESPONSE_HPP
 
 #include <string>
+#include <ctime>
 
 /*
 The Response class builds the HTTP response to be sent to the client.
@@ -22,8 +23,12 @@ class Response {
 	public:
 		Response();
 		static std::string getContentType(const std::string& path);
-		static std::string buildHeader(int statusCode, size_t contentLength, const std::string& contentType);
-		static std::string build(int statusCode, const std::string& body, const std::string& contentType);
+		static std::string buildHeader(int statusCode, size_t contentLength, const std::string& contentType,
+							bool keepAlive = false, const std::string& extraHeaders = "");
+		static std::string buildNotModified(bool keepAlive, const std::string& extraHeaders);
+		static std::string httpDate(time_t t);
+		static std::string build(int statusCode, const std::string& body, const std::string& contentType,
+							bool keepAlive = false);
 };
 
 #endif // RESPONSE_HPP
@@ -0,0 +1,90 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ResponseCache.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef RESPONSECACHE_HPP
+#define RESPONSECACHE_HPP
+
+#include <string>
+#include <map>
+#include <list>
+#include <utility>
+#include <ctime>
+#include <sys/types.h>
+
+#include "Mutex.hpp"
+
+struct FileInfo;
+
+/*
+In-memory cache of complete static responses (headers plus body) for small
+files, so a hot CSS or icon goes out with a single send() and no disk access.
+Entries are keyed by resolved path, Connection header and a variant naming what
+else went into the bytes (the location's Vary and Content-Encoding lines), so
+two locations serving one file never hand out each other's headers. They are
+checked against the file's inode, size and mtime on every hit, and evicted least recently used once the
+byte budget is spent. Shared by the reactor threads, hence the lock and the
+copy handed out by find().
+*/
+class ResponseCache {
+  private:
+    struct Key {
+      std::string path; //first, so invalidate() finds every variant of a path together
+      bool        keepAlive;
+      std::string variant;
+
+      Key(const std::string& path, bool keepAlive, const std::string& variant);
+      bool operator<(const Key& other) const;
+    };
+
+    struct Entry {
+      std::string response;
+      off_t       size;
+      time_t      mtime;
+      ino_t       ino;
+      std::list<Key>::iterator lru;
+    };
+
+    std::map<Key, Entry> _entries;
+    std::list<Key>       _lru; //most recently used first
+    size_t               _budget; //bytes of responses we may hold, 0 disables the cache
+    size_t               _maxFile; //larger files are always sent with sendfile()
+    size_t               _used;
+    unsigned long        _hits;
+    unsigned long        _misses;
+    mutable Mutex        _lock;
+
+    ResponseCache(const ResponseCache& other);
+    ResponseCache& operator=(const ResponseCache& other);
+
+    void    erase(std::map<Key, Entry>::iterator it);
+    void    reset();
+
+  public:
+    ResponseCache();
+    ~ResponseCache();
+
+    void                configure(size_t budget, size_t maxFile);
+    bool                accepts(const FileInfo& info) const;
+    bool                find(const std::string& path, bool keepAlive, const std::string& variant,
+                          const FileInfo& info, std::string& response);
+    void                store(const std::string& path, bool keepAlive, const std::string& variant,
+                          const FileInfo& info, const std::string& response);
+    void                invalidate(const std::string& path);
+    void                clear();
+    unsigned long       hits() const;
+    unsigned long       misses() const;
+};
+
+extern ResponseCache g_responseCache;
+extern ResponseCache g_gzipCache; //gzipped variants of static files, the variant is the gzip level
+
+#endif // RESPONSECACHE_HPP
@@ -0,0 +1,85 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RewriteEngine.hpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef REWRITEENGINE_HPP
+#define REWRITEENGINE_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <deque>
+#include <ctime>
+#include <regex.h>
+
+#include "Mutex.hpp"
+
+struct FileCachePolicy;
+
+/*
+A server's 'rewrite' and 'try_files' directives, compiled once when the config
+is parsed and never changed afterwards:
+- rewrite ^/home$ /index.html;       literal patterns go into a map,
+- rewrite ^/img/(.*)$ /images/$1;    the others are regcomp()ed, tried in order,
+  and the first match wins ($1..$9 are its groups),
+- try_files $uri $uri.html $uri/index.html $uri;   (or ... =404)
+  every entry but the last is probed on disk, the last one is the fallback.
+The outcome of the try_files probes is remembered per URI for
+try_files_cache_valid seconds, misses included, so repeated requests for
+files that don't exist stop touching the filesystem. PUT, DELETE and uploads
+drop the probes the changed file could have answered, and a full cache
+evicts its oldest probes first (the next to expire, the TTL is fixed).
+*/
+class RewriteEngine {
+  private:
+    struct Rule {
+      std::string pattern;
+      std::string replacement;
+      regex_t*    compiled;
+    };
+
+    struct Probe {
+      std::string uri; //what try_files resolved to
+      int         status; //fallback '=code', 0 otherwise
+      time_t      expires;
+    };
+
+    std::map<std::string, std::string>   _literal; //'^/path$' rules
+    std::vector<Rule>                     _rules; //regex rules, in config order
+    std::vector<std::string>              _tryFiles;
+    int                                   _probeTtl; //seconds, 0 disables the probe cache
+    mutable std::map<std::string, Probe>  _probes;
+    mutable std::deque<std::pair<std::string, time_t> > _probeOrder; //insertion order, may hold stale keys
+    mutable Mutex                         _probeLock; //the reactor threads share the config
+
+    void    evictProbes(time_t now) const;
+
+    void    compileRules();
+    void    freeRules();
+
+  public:
+    RewriteEngine();
+    RewriteEngine(const RewriteEngine& other);
+    RewriteEngine& operator=(const RewriteEngine& other);
+    ~RewriteEngine();
+
+    void        addRule(const std::string& pattern, const std::string& replacement);
+    void        setTryFiles(const std::vector<std::string>& entries);
+    void        setProbeTtl(int seconds);
+    void        compile();
+
+    std::string rewrite(const std::string& uri) const;
+    std::string tryFiles(const std::string& uri, const std::string& root, const FileCachePolicy& cache,
+                  int& status) const;
+    void        invalidate(const std::string& path, const std::string& root) const;
+};
+
+#endif // REWRITEENGINE_HPP
@@ -17,19 +17,53 @@
 #include <vector>
 #include <map>
 
+#include "OpenFileCache.hpp"
+#include "Gzip.hpp"
+#include "RateLimiter.hpp"
+#include "LocationRouter.hpp"
+#include "RewriteEngine.hpp"
+
 class LocationConfig;
+
+/*
+Socket options from the parameters of a 'listen' line:
+listen 127.0.0.1:8081 default_server backlog=1024 deferred fastopen=256 reuseport;
+*/
+struct	ListenOptions {
+	int		backlog; //listen() queue, the kernel caps it at net.core.somaxconn
+	bool	deferred; //TCP_DEFER_ACCEPT, wake us only once the request bytes are in
+	int		fastopen; //TCP_FASTOPEN queue length, 0 leaves it off
+	bool	reuseport; //SO_REUSEPORT, always on with worker_processes
+
+	ListenOptions();
+	bool	operator==(const ListenOptions& other) const;
+};
+
 struct	ServerConfig {
 		//raw is for testing, ensure we process everything (remove before finishing)
 	std::map<std::string, std::string> raw; //stores unprocessed directives
 	std::vector<int>			ports; //converted and valid ports pulled from listen_entries
 	std::vector<std::string>	listen_entries; //read initial ports as string
+	std::vector<int>			default_ports; //ports this block is the default_server of
+	std::map<int, ListenOptions>	listen_options; //per port, when the listen line had parameters
 	std::string					host; // IP or host name
-	std::string					server_name;
+	std::string					server_name; //names matched against the Host header, see VirtualHosts
 	std::string					root; //root directory for requests
 	std::string					index; //default directory if no URI provided
 	long						client_max_body_size;
+	size_t						client_max_header_size; //request line plus headers, larger ones get a 431
+	int							keepalive_timeout; //seconds an idle connection is kept, 0 disables keep-alive
+	int							keepalive_requests; //requests served before the connection is closed
+	int							client_header_timeout; //seconds for a whole request header to arrive
+	int							client_body_timeout; //seconds between two reads of a request body
+	int							send_timeout; //seconds a response may wait for the client to drain it
+	FileCachePolicy				open_file_cache; //default for the locations below it
+	GzipPolicy					gzip; //default for the locations below it
+	LimitReqPolicy				limit_req; //default for the locations below it
 	std::map<int, std::string>	error_pages; //error code and path
 	std::vector<LocationConfig>	locations; //location blocks
+	LocationRouter				routes; //locations compiled for matchLocation
+	RewriteEngine				rewrites; //rewrite and try_files, applied to GET requests
 
 	ServerConfig();
 
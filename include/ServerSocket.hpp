@@ -14,6 +14,7 @@
 # define SERVERSOCKET_HPP
 
 #include "ServerConfig.hpp"
+#include "VirtualHosts.hpp"
 # include <netinet/in.h>
 #include <vector>
 #include <string>
@@ -28,16 +29,18 @@ bool	safe_listen(int socket, int backlog);
 class ServerSocket {
   private:
     int           _fd;
-    ServerConfig  _config;
+    std::string   _address; //"host:port"
+    const VirtualHosts* _hosts; //the server blocks listening here, in the current config
   public:
     ServerSocket();
     ~ServerSocket();
 
-    bool	init(int port, const std::string& host);
-    void	setConfig(const ServerConfig& config);
-    const	ServerConfig& getConfig() const;
+    bool	init(int port, const std::string& host, const ListenOptions& options);
+    void	setHosts(const VirtualHosts& hosts);
+    const	VirtualHosts& getHosts() const;
+    const std::string& address() const;
 
-    int		acceptClient();
+    int		acceptClient(sockaddr_in& peer);
     void	closeSocket();
     int		getFD();
 };
@@ -0,0 +1,69 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.hpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <vector>
+#include <ctime>
+
+/*
+One timer, embedded in the object it times (a ClientConnection). It carries
+its own links in the slot's list, so arming, re-arming and cancelling only
+relink pointers and never allocate.
+*/
+struct TimerHandle {
+  int           fd; //reported by advance() when the timer fires
+  time_t        expires;
+  int           level; //-1 while not armed
+  int           slot;
+  TimerHandle*  prev; //neighbours in the slot's list, NULL at either end
+  TimerHandle*  next;
+
+  TimerHandle(int fd);
+  bool    armed() const;
+};
+
+/*
+Hierarchical timing wheel with one second ticks, one per event loop.
+Level 0 holds the next 64 seconds slot by slot, level 1 the next 64 * 64
+seconds in 64 second slots, level 2 about three days in 4096 second slots.
+schedule() and cancel() are O(1), advance() touches only the slot of each
+elapsed second, and moves a level 1 or 2 slot down every 64 or 4096 ticks.
+*/
+class TimerWheel {
+  private:
+    static const int  LEVELS = 3;
+    static const int  SLOT_BITS = 6;
+    static const int  SLOTS = 1 << SLOT_BITS;
+
+    TimerHandle*  _slots[LEVELS][SLOTS]; //first timer of each slot, NULL when empty
+    time_t        _now; //last tick processed
+    size_t        _count;
+
+    TimerWheel(const TimerWheel& other);
+    TimerWheel& operator=(const TimerWheel& other);
+
+    void    place(TimerHandle& timer);
+    void    unlink(TimerHandle& timer);
+    void    cascade(int level);
+
+  public:
+    TimerWheel(time_t now);
+
+    void    schedule(TimerHandle& timer, time_t expires);
+    void    cancel(TimerHandle& timer);
+    void    advance(time_t now, std::vector<int>& expired);
+    size_t  size() const;
+};
+
+#endif // TIMERWHEEL_HPP
@@ -0,0 +1,60 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   VirtualHosts.hpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef VIRTUALHOSTS_HPP
+#define VIRTUALHOSTS_HPP
+
+#include <string>
+#include <vector>
+
+#include "ServerConfig.hpp"
+
+/*
+The server blocks sharing one listening socket, selected per request by the
+Host header like nginx's name-based virtual servers. The server_name entries
+are hashed once at startup, a lookup then costs one probe for the exact name
+plus one per label for the wildcard forms, whatever the number of sites:
+- example.com         exact name,
+- *.example.com       leading wildcard, the longest one wins,
+- www.example.*       trailing wildcard, tried after the leading ones,
+- .example.com        both example.com and *.example.com.
+Requests whose Host matches nothing go to the default server: the block
+marked 'listen ... default_server', or else the first one on the socket.
+*/
+class VirtualHosts {
+  private:
+    struct Name {
+      std::string name;
+      size_t      server; //index in _servers
+    };
+
+    std::string                       _address; //"host:port", to find the same socket in a reloaded config
+    std::vector<ServerConfig>         _servers;
+    size_t                            _default; //the 'default_server' block, or the first one
+    std::vector<std::vector<Name> >   _buckets; //size is a power of two
+
+    void    insert(const std::string& name, size_t server);
+    const Name* find(const std::string& name) const;
+
+  public:
+    VirtualHosts();
+
+    void    add(const ServerConfig& server, bool isDefault);
+    void    build();
+    void    setAddress(const std::string& address);
+    const std::string& address() const;
+    const ServerConfig& select(const std::string& host) const;
+    const ServerConfig& defaultServer() const;
+    size_t  size() const;
+};
+
+#endif // VIRTUALHOSTS_HPP
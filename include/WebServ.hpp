@@ -22,9 +22,27 @@
 # include "Response.hpp"
 # include "LocationConfig.hpp"
 # include "ServerConfig.hpp"
+# include "GlobalConfig.hpp"
+# include "EventBackend.hpp"
+# include "MultipartParser.hpp"
+# include "OpenFileCache.hpp"
+# include "ResponseCache.hpp"
+# include "ByteRange.hpp"
+# include "Gzip.hpp"
+# include "LocationRouter.hpp"
+# include "RewriteEngine.hpp"
+# include "VirtualHosts.hpp"
+# include "Mutex.hpp"
+# include "TimerWheel.hpp"
+# include "Reactor.hpp"
+# include "Admission.hpp"
+# include "RateLimiter.hpp"
+# include "ConnectionTable.hpp"
+# include "ConfigSnapshot.hpp"
 
 # include <sys/socket.h>
 # include <netinet/in.h>
+# include <netinet/tcp.h> // TCP_DEFER_ACCEPT, TCP_FASTOPEN
 # include <unistd.h>
 # include <cstring>
 # include <iostream>
@@ -51,9 +69,12 @@
 # include <arpa/inet.h>  // for inet_pton
 # include <netdb.h>      // for gethostbyname and struct hostent
 # include <limits.h>     // for PATH_MAX
+# include <new>          // placement new, for the connection slab
 
 #define _XOPEN_SOURCE_EXTENDED 1
-extern int g_signal;
+#define MAX_ACCEPTS_PER_WAKEUP 64 //listeners are level-triggered, what is left wakes us again
+extern volatile sig_atomic_t g_signal;
+extern volatile sig_atomic_t g_reload; //set by SIGHUP, cleared by the thread that reloads
 
 class ServerSocket;
 class ClientConnection;
@@ -61,60 +82,75 @@ class Response;
 
 
 std::string	intToStr(int n);
+std::vector<std::string> line_splitter(const std::string& line);
 std::string	trim(std::string& s);
 std::string	cleanValue(std::string s);
 std::string	getContentType(const std::string& path);
 int			safe_socket(int domain, int type, int protocol);
 bool		safe_bind(int fd, sockaddr_in & addr);
 bool		safe_listen(int socket, int backlog);
-void		shutDownWebserv(std::vector<ServerSocket*>& serverSockets, std::map<int, ClientConnection*>& clients);
+void		shutDownWebserv(ConnectionTable& table);
 void 		handleUpload(const std::string &request, int client_fd, const ServerConfig &config);
-void 		serveStaticFile(std::string path, int client_fd, const ServerConfig &config);
+void 		serveStaticFile(std::string path, ClientConnection& client, const Request& req,
+				const LocationConfig& location, const ServerConfig &config);
 std::string	getInterpreter(const std::string& path, const ServerConfig& config);
-void 		handleCgi(const Request req, int fd, const ServerConfig& config, std::string interpreter);
+void 		handleCgi(const Request& req, ClientConnection& client, const ServerConfig& config, std::string interpreter);
 std::string	getErrorPageBody(int code, const ServerConfig& config);
-void 		sendHtmlResponse(int fd, int code, const std::string& body);
+std::string	fileETag(const FileInfo& info);
+std::string	validatorHeaders(const FileInfo& info);
+bool		isNotModified(const Request& req, const FileInfo& info);
+bool		acceptsEncoding(const std::string& acceptEncoding, const std::string& coding);
+void		sendNotModified(ClientConnection& client, const FileInfo& info);
+void 		sendHtmlResponse(ClientConnection& client, int code, const std::string& body);
 std::string	buildHtmlResponse(int code, const std::string& body);
 bool		validatePort(const std::string& portString);
 void		convertListenEntriesToPortsAndHost(ServerConfig& server);
 void 		checkDuplicateHostPortPairs(const std::vector<ServerConfig>& servers);
-void		runEventLoop(std::vector<struct pollfd>& fds, std::map<int, ServerSocket*>& fdToSocket,
-				std::map<int, ClientConnection*>& clients, std::map<int, ServerSocket*>& clientToServer);
-bool 		initialiseSockets(const std::vector<ServerConfig>& servers, std::vector<ServerSocket*>& serverSockets,
-				std::vector<struct pollfd>& fds, std::map<int, ServerSocket*>& fdToSocket);
-void		handleExistingClient(int fd, std::vector<pollfd> &fds, std::map<int, ClientConnection*>& clients, size_t& i,
-				const ServerConfig& config);
-void		handleNewClient(ServerSocket* server, std::vector<pollfd> &fds, std::map<int, ClientConnection*>& clients,
-				std::map<int, ServerSocket*>& clientToServer);
-LocationConfig	matchLocation(const std::string& path, const ServerConfig& config);
+void		runEventLoop(EventBackend& events, ConnectionTable& table, Reactor* reactor);
+bool 		initialiseSockets(const ConfigSnapshot& config, EventBackend& events, ConnectionTable& table,
+				bool reusePort);
+bool		reparseConfig(ConfigParser& parser);
+void		reloadConfig(EventBackend& events, ConnectionTable& table);
+void		applyGlobalConfig(const GlobalConfig& global);
+int			serveWebserv(const ConfigParser& parser, bool reusePort);
+int			runMaster(const ConfigParser& parser, int workers);
+void		handleExistingClient(int fd, EventBackend& events, ConnectionTable& table,
+				const LoadShedder& shedder);
+void		serveBufferedRequests(int fd, EventBackend& events, ConnectionTable& table,
+				const LoadShedder& shedder);
+void		processRequest(ClientConnection& client, const Request& req, const ServerConfig& config);
+void		handleNewClient(ServerSocket* server, EventBackend& events, ConnectionTable& table,
+				TimerWheel& timers);
+void		registerClient(int client_fd, const sockaddr_in& peer, ConfigSnapshot* snapshot, const VirtualHosts& hosts,
+				EventBackend& events, ConnectionTable& table, TimerWheel& timers);
+const LocationConfig*	matchLocation(const std::string& path, const ServerConfig& config);
 // Add function declarations to WebServ.hpp
-void		handleGet(int fd, const std::string& path, const LocationConfig& location, const ServerConfig& config);
-void		handlePost(int fd, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config);
-void		handlePut(int fd, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config);
-void		handleDelete(int fd, const std::string& path, const LocationConfig& location, const ServerConfig& config);
-void		handleHead(int fd, const std::string& path, const LocationConfig& location, const ServerConfig& config);
+void		handleGet(ClientConnection& client, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config);
+void		handlePost(ClientConnection& client, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config);
+void		handlePut(ClientConnection& client, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config);
+void		handleDelete(ClientConnection& client, const std::string& path, const LocationConfig& location, const ServerConfig& config);
+void		handleHead(ClientConnection& client, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config);
 
 // Helper Functions
-void		handleClientCleanup(int fd, std::vector<pollfd>& fds, std::map<int, ClientConnection*>& clients, size_t& i);
+void		handleClientCleanup(int fd, EventBackend& events, ConnectionTable& table);
+void		handleClientWrite(int fd, EventBackend& events, ConnectionTable& table,
+				const LoadShedder& shedder);
+void		closeTimedOutConnections(EventBackend& events, ConnectionTable& table,
+				TimerWheel& timers, time_t now);
 bool		fileExists(const std::string& path);
 bool		isDirectory(const std::string& path);
 void		createDirectoryIfNotExists(const std::string& path);
 std::string	getContentType(const std::string& path);
 std::string	generateSimpleDirectoryListing(const std::string& dirPath, const std::string& urlPath);
-void		handleSimpleUpload(const std::string& request, int client_fd, const ServerConfig& config);
-void		handleSimpleCGI(int fd, const Request& req, const std::string& path, const ServerConfig& config);
+void		handleSimpleUpload(ClientConnection& client, const ServerConfig& config);
+MultipartParser*	openUploadStream(const Request& head, const ServerConfig& config);
+void		handleSimpleCGI(ClientConnection& client, const Request& req, const std::string& path, const ServerConfig& config);
 
 
 // URL Rewriting (if you haven't added this yet)
-std::string	rewriteURL(const std::string& path, const ServerConfig& config, const std::string& method);
+std::string	rewriteURL(const std::string& path, const ServerConfig& config, int& status);
 
 // Helper function prototypes (add these to your header file)
-bool		extractFilenameFromRequest(const std::string& request, std::string& filename);
-bool		findFileContentBoundaries(const std::string& request, const std::string& filename,
-							size_t& contentStart, size_t& contentEnd);
-bool		validateUploadFileSize(size_t fileSize, const ServerConfig& config);
-bool		writeFileToServer(const std::string& request, size_t contentStart, size_t contentLength,
-					const std::string& filePath);
 std::string	loadAndProcessSuccessTemplate(const ServerConfig& config, const std::string& filename);
 std::string	loadAndProcessDeleteTemplate(const ServerConfig& config, const std::string& filename);
 void		replaceTemplateVariables(std::string& templateContent, const std::string& filename, const std::string& action);
@@ -0,0 +1,161 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Admission.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+AdmissionControl g_admission;
+
+LoadShedder::LoadShedder(int targetMs, int intervalMs)
+	: _target(targetMs * 1000L), _interval(intervalMs * 1000L), _firstAbove(0), _shedding(false) {}
+
+/*
+One pass of the event loop, from the wakeup to the next wait. Like CoDel's
+dequeue: below target resets everything, the first pass above it starts the
+clock, and a pass above it one interval later turns shedding on.
+*/
+void	LoadShedder::record(long started, long finished) {
+	if (!_target)
+		return;
+	if (finished - started < _target) {
+		_firstAbove = 0;
+		if (_shedding)
+			std::cout << "🚦 Event loop back under " << _target / 1000 << "ms, serving again" << std::endl;
+		_shedding = false;
+		return;
+	}
+	if (!_firstAbove)
+		_firstAbove = finished + _interval;
+	else if (!_shedding && finished >= _firstAbove) {
+		_shedding = true;
+		std::cout << "🚦 Event loop over " << _target / 1000 << "ms for " << _interval / 1000
+			<< "ms, shedding new requests" << std::endl;
+	}
+}
+
+bool	LoadShedder::shedding() const {
+	return _shedding;
+}
+
+Admitted::Admitted() : admitted(false), counted(false), ip(0) {}
+
+AdmissionControl::AdmissionControl()
+	: _maxConnections(0), _maxPerIp(0), _shedTarget(0), _shedInterval(0), _active(0) {}
+
+void	AdmissionControl::configure(const GlobalConfig& global) {
+	ScopedLock lock(_lock);
+	_maxConnections = global.worker_connections;
+	_maxPerIp = global.limit_conn_per_ip;
+	_shedTarget = global.shed_target;
+	_shedInterval = global.shed_interval;
+}
+
+/*
+Counts the connection in, or returns false when it would go over
+worker_connections or over limit_conn_per_ip for its address.
+*/
+bool	AdmissionControl::admit(int fd, in_addr_t ip) {
+	ScopedLock lock(_lock);
+	if (_maxConnections && _active >= _maxConnections) {
+		std::cerr << "🚫 worker_connections (" << _maxConnections << ") reached, refusing " << fd << std::endl;
+		return false;
+	}
+	if (_maxPerIp) {
+		int& fromIp = _perIp[ip];
+		if (fromIp >= _maxPerIp) {
+			char address[INET_ADDRSTRLEN];
+			in_addr addr;
+			addr.s_addr = ip;
+			inet_ntop(AF_INET, &addr, address, sizeof(address));
+			std::cerr << "🚫 limit_conn_per_ip (" << _maxPerIp << ") reached for " << address << std::endl;
+			return false;
+		}
+		++fromIp;
+	}
+	++_active;
+	if (static_cast<size_t>(fd) >= _byFd.size())
+		_byFd.resize(std::max(static_cast<size_t>(fd) + 1, _byFd.size() * 2));
+	Admitted& entry = _byFd[fd];
+	entry.admitted = true;
+	entry.counted = _maxPerIp != 0;
+	entry.ip = ip;
+	return true;
+}
+
+//must run before the fd is closed, another thread could accept the same number right after
+void	AdmissionControl::release(int fd) {
+	ScopedLock lock(_lock);
+	if (fd < 0 || static_cast<size_t>(fd) >= _byFd.size() || !_byFd[fd].admitted)
+		return;
+	Admitted& entry = _byFd[fd];
+	if (entry.counted) {
+		std::map<in_addr_t, int>::iterator fromIp = _perIp.find(entry.ip);
+		if (fromIp != _perIp.end() && --fromIp->second <= 0)
+			_perIp.erase(fromIp);
+	}
+	entry = Admitted();
+	--_active;
+}
+
+size_t	AdmissionControl::active() {
+	ScopedLock lock(_lock);
+	return _active;
+}
+
+int		AdmissionControl::shedTarget() const {
+	return _shedTarget;
+}
+
+int		AdmissionControl::shedInterval() const {
+	return _shedInterval;
+}
+
+long	monotonicMicros() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+}
+
+//the clock of the timer wheels, a step of the wall clock must not stall or fire them
+time_t	monotonicSeconds() {
+	return monotonicMicros() / 1000000;
+}
+
+static std::string	buildUnavailableResponse() {
+	std::string body = "<html><body><h1>503 Service Unavailable</h1>"
+		"<p>The server is overloaded, please retry.</p></body></html>";
+	return "HTTP/1.1 503 Service Unavailable\r\n"
+		"Content-Type: text/html\r\n"
+		"Content-Length: " + intToStr(static_cast<int>(body.size())) + "\r\n"
+		"Retry-After: 1\r\n"
+		"Connection: close\r\n\r\n" + body;
+}
+
+/*
+Built once at startup: shedding must be cheaper than serving, so no error
+page lookup, no formatting, no allocation beyond the copy into the queue.
+*/
+static const std::string g_unavailable = buildUnavailableResponse();
+
+const std::string&	unavailableResponse() {
+	return g_unavailable;
+}
+
+/*
+A connection we won't serve: best effort 503 straight into the fresh socket
+buffer, then close. A request already sent may turn the close into a reset,
+clients that read first still see the Retry-After.
+*/
+void	rejectConnection(int fd) {
+	ssize_t ignored = send(fd, g_unavailable.data(), g_unavailable.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+	(void)ignored;
+	close(fd);
+}
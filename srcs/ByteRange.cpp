@@ -0,0 +1,162 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ByteRange.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+//more ranges than this in one request and we just send the whole file
+static const size_t	MAX_RANGES = 16;
+
+//numbers the multipart boundaries, bumped atomically: every reactor thread sends 206s
+static unsigned long	g_boundaryCounter = 0;
+
+ByteRange::ByteRange(off_t first, off_t last) : first(first), last(last) {}
+
+off_t	ByteRange::length() const {
+	return last - first + 1;
+}
+
+//digits only, false on anything else or overflow
+static bool	parseOffset(const std::string& s, off_t& out) {
+	if (s.empty() || s.size() > 18)
+		return false;
+	out = 0;
+	for (size_t i = 0; i < s.size(); ++i) {
+		if (s[i] < '0' || s[i] > '9')
+			return false;
+		out = out * 10 + (s[i] - '0');
+	}
+	return true;
+}
+
+/*
+Parses "bytes=0-499", "bytes=500-", "bytes=-500" and comma separated lists of
+them against a file of fileSize bytes. Unsatisfiable specs are dropped, when
+none is left the answer is 416.
+*/
+RangeResult	parseRangeHeader(const std::string& header, off_t fileSize, std::vector<ByteRange>& ranges) {
+	ranges.clear();
+	if (header.compare(0, 6, "bytes=") != 0)
+		return RANGE_IGNORED;
+
+	size_t specs = 0;
+	size_t pos = 6;
+	while (pos <= header.size()) {
+		size_t comma = header.find(',', pos);
+		if (comma == std::string::npos)
+			comma = header.size();
+		std::string spec = header.substr(pos, comma - pos);
+		pos = comma + 1;
+		trim(spec);
+		if (spec.empty())
+			continue;
+		if (++specs > MAX_RANGES)
+			return RANGE_IGNORED;
+
+		size_t dash = spec.find('-');
+		if (dash == std::string::npos)
+			return RANGE_IGNORED;
+		std::string firstPart = spec.substr(0, dash);
+		std::string lastPart = spec.substr(dash + 1);
+		off_t first, last;
+		if (firstPart.empty()) {
+			//suffix range: the last N bytes
+			if (!parseOffset(lastPart, last))
+				return RANGE_IGNORED;
+			if (last == 0 || fileSize == 0)
+				continue;
+			first = last >= fileSize ? 0 : fileSize - last;
+			last = fileSize - 1;
+		}
+		else {
+			if (!parseOffset(firstPart, first))
+				return RANGE_IGNORED;
+			if (lastPart.empty())
+				last = fileSize - 1;
+			else if (!parseOffset(lastPart, last) || last < first)
+				return RANGE_IGNORED;
+			if (first >= fileSize)
+				continue;
+			if (last >= fileSize)
+				last = fileSize - 1;
+		}
+		ranges.push_back(ByteRange(first, last));
+	}
+	if (!specs)
+		return RANGE_IGNORED;
+	return ranges.empty() ? RANGE_NOT_SATISFIABLE : RANGE_SATISFIABLE;
+}
+
+static std::string	contentRange(off_t first, off_t last, off_t fileSize) {
+	std::ostringstream oss;
+	oss << "bytes " << first << "-" << last << "/" << fileSize;
+	return oss.str();
+}
+
+/*
+Queues a 206 for the ranges, straight from the file like a normal static
+response. One range is sent as is, several become a multipart/byteranges body
+whose part headers are small strings between the file ranges.
+The connection takes ownership of fileFd, except when false is returned: the
+descriptors for the parts could not be made and nothing was queued, the
+caller still owns fileFd and sends the whole file instead.
+*/
+bool	queueByteRanges(ClientConnection& client, int fileFd, off_t fileSize,
+			const std::string& contentType, const std::vector<ByteRange>& ranges,
+			const std::string& extraHeaders) {
+	if (ranges.size() == 1) {
+		const ByteRange& range = ranges[0];
+		std::string extra = extraHeaders
+			+ "Content-Range: " + contentRange(range.first, range.last, fileSize) + "\r\n";
+		client.queueOutput(Response::buildHeader(206, range.length(), contentType, client.keepAlive(), extra));
+		client.queueFile(fileFd, range.first, range.length());
+		return true;
+	}
+
+	//every file chunk owns its descriptor, the last one gets the original; all
+	//of them exist before anything is queued, a Content-Length is never broken
+	std::vector<int> fds;
+	for (size_t i = 0; i + 1 < ranges.size(); ++i) {
+		int fd = fcntl(fileFd, F_DUPFD_CLOEXEC, 0);
+		if (fd == -1) {
+			std::cerr << "⚠️ Could not dup the file for a multipart range: " << strerror(errno) << std::endl;
+			for (size_t j = 0; j < fds.size(); ++j)
+				close(fds[j]);
+			return false;
+		}
+		fds.push_back(fd);
+	}
+	fds.push_back(fileFd);
+
+	std::ostringstream boundary;
+	boundary << "webserv_" << std::hex << time(NULL) << "_" << __sync_add_and_fetch(&g_boundaryCounter, 1);
+
+	std::vector<std::string> partHeaders;
+	size_t length = 0;
+	for (size_t i = 0; i < ranges.size(); ++i) {
+		std::string part = "\r\n--" + boundary.str() + "\r\n"
+			+ "Content-Type: " + contentType + "\r\n"
+			+ "Content-Range: " + contentRange(ranges[i].first, ranges[i].last, fileSize) + "\r\n\r\n";
+		partHeaders.push_back(part);
+		length += part.size() + ranges[i].length();
+	}
+	std::string closing = "\r\n--" + boundary.str() + "--\r\n";
+	length += closing.size();
+
+	client.queueOutput(Response::buildHeader(206, length,
+		"multipart/byteranges; boundary=" + boundary.str(), client.keepAlive(), extraHeaders));
+	for (size_t i = 0; i < ranges.size(); ++i) {
+		client.queueOutput(partHeaders[i]);
+		client.queueFile(fds[i], ranges[i].first, ranges[i].length());
+	}
+	client.queueOutput(closing);
+	return true;
+}
@@ -32,15 +32,6 @@ std::string getInterpreter(const std::string& path, const ServerConfig& config)
 	return "";
 }
 
-const LocationConfig* findMatchingLocation(const std::string& path, const ServerConfig& config) {
-	for (size_t i = 0; i < config.locations.size(); ++i) {
-		if (path.find(config.locations[i].path) == 0) {
-			return &config.locations[i];
-		}
-	}
-	return NULL;
-}
-
 /*
 launching an external interpreter (i.e. Python or PHP) to run a script
 and send the output to the client
@@ -50,8 +41,8 @@ WebServ acts like a middleman
 	-gets the output (i.e.HTML) back
 	-forward it to the browser
 */
-void handleCgi(const Request req, int fd, const ServerConfig& config, std::string interpreter) {
-	const LocationConfig* location = findMatchingLocation(req.getPath(), config);
+void handleCgi(const Request& req, ClientConnection& client, const ServerConfig& config, std::string interpreter) {
+	const LocationConfig* location = matchLocation(req.getPath(), config);
 	if (!location) {
 		std::cerr << "❌ Location for CGI request does not match\n";
 		return;
@@ -102,7 +93,7 @@ void handleCgi(const Request req, int fd, const ServerConfig& config, std::strin
 		std::string method = req.getMethod();
 		std::string pathInfo = req.getPath();
 		std::ostringstream oss;
-		oss << req.getBody().length();
+		oss << req.getBodySize();
 		std::string contentLengthStr = oss.str();
 
 		//make "CGI headers but passed through execve() instead of HTTP stream"
@@ -117,6 +108,8 @@ void handleCgi(const Request req, int fd, const ServerConfig& config, std::strin
 		envStrings.push_back("CONTENT_LENGTH=" + contentLengthStr);
 		envStrings.push_back("CONTENT_TYPE=text/plain");
 		envStrings.push_back("QUERY_STRING=" + req.getQuery());
+		envStrings.push_back("REMOTE_ADDR=" + client.peerAddress());
+		envStrings.push_back("REMOTE_PORT=" + intToStr(client.peerPort()));
 		envStrings.push_back("SCRIPT_NAME=" + relativePath);
 
 		std::vector<char*> envp;
@@ -135,7 +128,7 @@ void handleCgi(const Request req, int fd, const ServerConfig& config, std::strin
 
 		//send body to CGI if POST method
 		if (req.getMethod() == "POST")
-			write(inputPipe[1], req.getBody().c_str(), req.getBody().length());
+			write(inputPipe[1], req.getBodyData(), req.getBodySize());
 		close(inputPipe[1]);
 
 		//read from CGI output and send to client
@@ -152,18 +145,16 @@ void handleCgi(const Request req, int fd, const ServerConfig& config, std::strin
 		if (headerEnd != std::string::npos)
 			body = body.substr(headerEnd + 4);
 		std::ostringstream fullResponse;
-		sendHtmlResponse(fd, 200, body);
+		sendHtmlResponse(client, 200, body);
 
 		std::string responseStr = fullResponse.str();
 		if (responseStr.empty()) {
 			std::string errorBody = getErrorPageBody(500, config);
-			sendHtmlResponse(fd, 500, errorBody);
+			sendHtmlResponse(client, 500, errorBody);
 			std::cerr << "❌ Empty CGI output — sending 500\n";
 			return;
 		}
-		ssize_t sent = send(fd, responseStr.c_str(), responseStr.length(), 0);
-		if (sent != (ssize_t)responseStr.length())
-			std::cerr << "❌ CGI response was interrupted\n";
+		client.queueOutput(responseStr);
 		std::cout << "📤 CGI output:\n" << responseStr << std::endl;
 	}
 
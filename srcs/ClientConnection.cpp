@@ -12,87 +12,485 @@
 
 #include "WebServ.hpp"
 
-ClientConnection::ClientConnection(int fd) : _fd(fd) {
-	int flags = fcntl(_fd, F_GETFL, 0);
-	if (!(flags & O_NONBLOCK))
-		fcntl(_fd, F_SETFL, flags | O_NONBLOCK);
+OutputChunk::OutputChunk() : fileFd(-1), offset(0), remaining(0) {}
+
+/*
+Takes over the caller's reference to snapshot, hosts must belong to it.
+*/
+ClientConnection::ClientConnection(int fd, const sockaddr_in& peer, ConfigSnapshot* snapshot,
+	const VirtualHosts& hosts, TimerWheel& timers) : _fd(fd), _peer(peer),
+	_state(READING_HEADERS), _scanOffset(0), _headerEnd(0), _contentLength(0), _upload(NULL), _bodyStreamed(0),
+	_limited(false), _peerClosed(false), _moreToRead(false), _wantWrite(false), _keepAlive(false), _keepAliveTimeout(0), _requestCount(0), _idle(false),
+	_gzip(NULL), _snapshot(snapshot), _hosts(&hosts), _config(&hosts.defaultServer()), _timers(&timers), _timer(fd),
+	_timerKind(TIMER_NONE) {
+	//accept4() already made the fd non-blocking
 }
 
 int	ClientConnection::getFd() const {
 	return _fd;
 }
 
+//network byte order, the key of limit_conn_per_ip and limit_req
+in_addr_t	ClientConnection::peerIp() const {
+	return _peer.sin_addr.s_addr;
+}
+
+std::string	ClientConnection::peerAddress() const {
+	char address[INET_ADDRSTRLEN];
+	if (!inet_ntop(AF_INET, &_peer.sin_addr, address, sizeof(address)))
+		return "";
+	return address;
+}
+
+int	ClientConnection::peerPort() const {
+	return ntohs(_peer.sin_port);
+}
+
+bool	ClientConnection::peerClosed() const {
+	return _peerClosed;
+}
+
+bool	ClientConnection::moreToRead() const {
+	return _moreToRead;
+}
+
 void	ClientConnection::closeConnection() {
 	if (_fd != -1)
 		close(_fd);
 }
 
 ClientConnection::~ClientConnection() {
+	_timers->cancel(_timer);
+	while (!_output.empty())
+		popOutput();
+	delete _upload;
+	g_admission.release(_fd); //before the number can be handed out again
 	closeConnection();
+	_snapshot->release();
 }
 
 /*
 -We use non-blockeing recv() safely
--server reads one full file at a time per client connection
+-the fd is edge-triggered, so we keep reading until the kernel says EAGAIN,
+ otherwise the rest of the data would never wake us up again
 -gracefully handles slow clients and disconnects
--exits cleanly after each transfer
+-but we stop as soon as a whole request is in: pipelined requests stay in the
+ socket until the responses before them are out, a client that never reads
+ can't make us buffer without bound. moreToRead() tells the caller to come
+ back, no new edge will
+-returns the number of bytes read (0 can also be a spurious wakeup, check
+ peerClosed() for a disconnect) and -1 on error
 */
-int ClientConnection::recvFullRequest(int client_fd, const ServerConfig& config) {
+int ClientConnection::recvFullRequest(int client_fd) {
 	//switched to vector to handle images and pdfs
 	char buffer[8192];//8 kb buffer size
-	int bytes = recv(client_fd, buffer, sizeof(buffer), 0);
+	int total = 0;
 
-	if (bytes <= 0) {
-		if (bytes == 0)
+	_moreToRead = false;
+	while (_state != HEADERS_TOO_LARGE) {
+		if (_state == REQUEST_COMPLETE) {
+			_moreToRead = true;
+			break;
+		}
+		ssize_t bytes = recv(client_fd, buffer, sizeof(buffer), 0);
+		if (bytes > 0) {
+			this->_buffer.insert(this->_buffer.end(), buffer, buffer + bytes);
+			total += bytes;
+			//parse per read so a streamed upload never piles up in _buffer
+			advanceParser();
+			if (_state == HEADERS_TOO_LARGE)
+				break; //the 431 is queued, the rest is never read
+			continue;
+		}
+		if (bytes == 0) {
 			std::cerr << "Client disconnected cleanly\n";
-		else {
-			std::cerr << "⚠️ Connection closed or recv failed during recvFullRequest\n";
-			std::string body = getErrorPageBody(500, config);
-			sendHtmlResponse(client_fd, 500, body);
+			//still hand over whatever arrived before the FIN
+			_peerClosed = true;
+			break;
 		}
-		return bytes;
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			break;
+		if (errno == EINTR)
+			continue;
+		std::cerr << "⚠️ Connection closed or recv failed during recvFullRequest\n";
+		std::string body = getErrorPageBody(500, *_config);
+		sendHtmlResponse(*this, 500, body);
+		return -1;
+	}
+	//headers may still be incomplete here, the caller waits for the next edge
+	return total;
+}
+
+/*
+Resumable parser for the request at the front of _buffer, run after each recv().
+Only the bytes that arrived since the last call are scanned for the end of the
+headers, and Content-Length is parsed exactly once, so a large upload costs
+O(size) in total instead of a rescan of the whole buffer on every read.
+Once the headers are in, the Host header picks the server block, limit_req is
+checked and multipart uploads switch to streaming their body to disk. A request
+over its rate never opens an upload, its body is read and dropped. A header block that outgrows
+client_max_header_size (of the listener's default server, Host is not known
+yet) is answered with 431 and the connection closes behind it.
+*/
+void ClientConnection::advanceParser() {
+	if (_state == READING_HEADERS) {
+		const char* data = _buffer.empty() ? NULL : &_buffer[0];
+		size_t size = _buffer.size();
+		size_t i = _scanOffset;
+		while (i + 3 < size) {
+			if (data[i] == '\r' && data[i + 1] == '\n' && data[i + 2] == '\r' && data[i + 3] == '\n')
+				break;
+			++i;
+		}
+		if (i + 3 >= size) {
+			//the terminator may straddle this read and the next one
+			_scanOffset = size > 3 ? size - 3 : 0;
+			if (size > _config->client_max_header_size)
+				rejectHeaders();
+			return;
+		}
+		if (i + 4 > _config->client_max_header_size) {
+			rejectHeaders();
+			return;
+		}
+		_headerEnd = i + 4;
+		parseHeaderFields();
+		_state = READING_BODY;
+		Request head(&_buffer[0], _headerEnd);
+		followReload();
+		_config = &_hosts->select(head.getHeader("host"));
+		_limited = overRequestLimit(head);
+		if (!_limited)
+			_upload = openUploadStream(head, *_config);
+	}
+	if (_state != READING_BODY)
+		return;
+	if (_upload || _limited)
+		streamBody();
+	else if (_buffer.size() - _headerEnd >= _contentLength)
+		_state = REQUEST_COMPLETE;
+}
+
+/*
+limit_req of the location the URI asks for, before rewrite, try_files or an
+upload touch the disk. Takes a token when the request is allowed.
+*/
+bool ClientConnection::overRequestLimit(const Request& head) const {
+	if (!g_requestLimiter.enabled())
+		return false;
+	const LocationConfig* location = matchLocation(head.getPath(), *_config);
+	if (!location || g_requestLimiter.allow(location->limit_req, peerIp()))
+		return false;
+	std::cout << "🐢 limit_req: " << peerAddress() << " over zone " << location->limit_req.zone << std::endl;
+	return true;
+}
+
+void ClientConnection::rejectHeaders() {
+	std::cerr << "⚠️ Header over client_max_header_size (" << _config->client_max_header_size
+		<< ") on client " << _fd << std::endl;
+	_buffer.clear();
+	_scanOffset = 0;
+	_state = HEADERS_TOO_LARGE;
+	setKeepAlive(false, 0);
+	sendHtmlResponse(*this, 431, getErrorPageBody(431, *_config));
+}
+
+/*
+Every request starts on the newest configuration: after a SIGHUP the
+connection moves to the new snapshot before its next request picks a server
+block, the previous request was served (and queued) on the old one. If our
+listener is gone from the new config the connection finishes on the old one.
+*/
+void ClientConnection::followReload() {
+	ConfigSnapshot* newer = g_configs.acquireIfNewer(_snapshot);
+	if (!newer)
+		return;
+	const VirtualHosts* hosts = newer->hosts(_hosts->address());
+	if (!hosts) {
+		newer->release();
+		return;
 	}
-	this->_buffer.insert(this->_buffer.end(), buffer, buffer + bytes);
-	std::string reqStr(_buffer.begin(), _buffer.end());
-	size_t headerEnd = reqStr.find("\r\n\r\n");
-	if (headerEnd == std::string::npos) {
-		std::cerr << "❌ Incomplete headers\n";
-		std::string body = getErrorPageBody(400, config);
-		sendHtmlResponse(client_fd, 400, body);
-		return bytes;
+	ConfigSnapshot* older = _snapshot;
+	_snapshot = newer;
+	_hosts = hosts;
+	_config = &_hosts->defaultServer();
+	older->release(); //may free it, nothing of ours points into it anymore
+}
+
+/*
+Hands the body bytes sitting behind the headers to the upload parser (or to
+nobody, for a rate-limited request) and drops them from the buffer. Bytes past Content-Length belong to the next request.
+*/
+void ClientConnection::streamBody() {
+	size_t available = _buffer.size() - _headerEnd;
+	size_t needed = _contentLength - _bodyStreamed;
+	size_t length = std::min(available, needed);
+	if (length) {
+		if (_upload)
+			_upload->feed(&_buffer[_headerEnd], length);
+		_buffer.erase(_buffer.begin() + _headerEnd, _buffer.begin() + _headerEnd + length);
+		_bodyStreamed += length;
 	}
-	// Found end of headers, check for Content-Length
-	size_t contentLengthPos = reqStr.find("Content-Length:");
-	if (contentLengthPos != std::string::npos) {
-		size_t valueStart = contentLengthPos + 15; // Length of "Content-Length:"
-		size_t valueEnd = reqStr.find("\r\n", valueStart);
-		if (valueEnd != std::string::npos) {
-			std::string lengthStr = reqStr.substr(valueStart, valueEnd - valueStart);
-			size_t totalContentLength = atoi(lengthStr.c_str());
-			size_t bodyStart = headerEnd + 4;
-			if (_buffer.size() - bodyStart < totalContentLength)
-				return bytes;
+	if (_bodyStreamed == _contentLength)
+		_state = REQUEST_COMPLETE;
+}
+
+/*
+Pulls the framing information out of the header block. Only Content-Length
+matters here, the full header parsing happens later in Request.
+*/
+void ClientConnection::parseHeaderFields() {
+	static const char	name[] = "content-length:";
+	const size_t		nameLength = sizeof(name) - 1;
+
+	_contentLength = 0;
+	size_t lineStart = 0;
+	while (lineStart < _headerEnd) {
+		size_t lineEnd = lineStart;
+		while (lineEnd < _headerEnd && _buffer[lineEnd] != '\n')
+			++lineEnd;
+		if (lineEnd - lineStart > nameLength) {
+			size_t j = 0;
+			while (j < nameLength && std::tolower(static_cast<unsigned char>(_buffer[lineStart + j])) == name[j])
+				++j;
+			if (j == nameLength) {
+				std::string value(_buffer.begin() + lineStart + nameLength, _buffer.begin() + lineEnd);
+				_contentLength = std::strtoul(value.c_str(), NULL, 10);
+				return;
+			}
 		}
+		lineStart = lineEnd + 1;
 	}
-	return bytes;
+}
+
+ClientState ClientConnection::getState() const {
+	return _state;
 }
 
 bool ClientConnection::isRequestComplete() const {
-	std::string reqStr(_buffer.begin(), _buffer.end());
-	size_t headerEnd = reqStr.find("\r\n\r\n");
-	if (headerEnd == std::string::npos)
-		return false;
-	size_t contentLengthPos = reqStr.find("Content-Length:");
-	if (contentLengthPos == std::string::npos)
-		return true;
-	size_t valueStart = contentLengthPos + 15; // Length of "Content-Length:"
-	size_t valueEnd = reqStr.find("\r\n", valueStart);
-	std::string lengthStr = reqStr.substr(valueStart, valueEnd - valueStart);
-	size_t totalLength = atoi(lengthStr.c_str());
-	size_t bodyStart = headerEnd + 4;
-	return (_buffer.size() - bodyStart >= totalLength);
-}
-
-std::string ClientConnection::getRawRequest() const {
-	return std::string(_buffer.begin(), _buffer.end());
-}
\ No newline at end of file
+	return _state == REQUEST_COMPLETE;
+}
+
+//size of the first request (headers plus buffered body) once it is complete, 0 before
+size_t ClientConnection::requestLength() const {
+	if (_state != REQUEST_COMPLETE)
+		return 0;
+	if (_upload || _limited)
+		return _headerEnd; //the body already went to disk, or was dropped
+	return _headerEnd + _contentLength;
+}
+
+const ServerConfig& ClientConnection::config() const {
+	return *_config;
+}
+
+MultipartParser* ClientConnection::getUpload() const {
+	return _upload;
+}
+
+bool ClientConnection::rateLimited() const {
+	return _limited;
+}
+
+size_t ClientConnection::contentLength() const {
+	return _contentLength;
+}
+
+/*
+Start of the complete request at the front of the buffer. Request slices point
+in here, so the buffer must not change until consumeRequest().
+*/
+const char* ClientConnection::requestData() const {
+	return _buffer.empty() ? "" : &_buffer[0];
+}
+
+/*
+Drops the first complete request from the buffer and restarts the parser on
+whatever follows it, which may already be the next pipelined request.
+*/
+void ClientConnection::consumeRequest() {
+	size_t length = requestLength();
+	_buffer.erase(_buffer.begin(), _buffer.begin() + length);
+	_state = READING_HEADERS;
+	_scanOffset = 0;
+	_headerEnd = 0;
+	_contentLength = 0;
+	delete _upload;
+	_upload = NULL;
+	_bodyStreamed = 0;
+	_limited = false;
+	_config = &_hosts->defaultServer();
+	if (!_buffer.empty())
+		advanceParser();
+}
+
+/*
+Responses are appended to a per-connection queue instead of being sent directly,
+a slow client can't take a large file in one send() on a non-blocking socket.
+*/
+void	ClientConnection::queueOutput(const std::string& data) {
+	if (data.empty())
+		return;
+	_output.push_back(OutputChunk());
+	_output.back().data = data;
+}
+
+/*
+Queues length bytes of an open file, starting at offset. The connection takes
+ownership of fileFd and closes it once the range is sent.
+*/
+void	ClientConnection::queueFile(int fileFd, off_t offset, size_t length) {
+	if (!length) {
+		close(fileFd);
+		return;
+	}
+	_output.push_back(OutputChunk());
+	_output.back().fileFd = fileFd;
+	_output.back().offset = offset;
+	_output.back().remaining = length;
+}
+
+bool	ClientConnection::hasPendingOutput() const {
+	return !_output.empty();
+}
+
+void	ClientConnection::popOutput() {
+	if (_output.front().fileFd != -1)
+		close(_output.front().fileFd);
+	_output.pop_front();
+}
+
+/*
+Sends as much of the queue as the socket accepts, resuming partial writes.
+File ranges go out with sendfile(), which advances the chunk's offset itself.
+Returns 0 once everything is sent, 1 if the socket is full and -1 on error.
+MSG_NOSIGNAL keeps a vanished client from killing us with SIGPIPE, MSG_MORE
+lets the headers share a packet with the file data that follows them.
+*/
+int	ClientConnection::flushOutput() {
+	while (!_output.empty()) {
+		OutputChunk& chunk = _output.front();
+		ssize_t sent;
+		if (chunk.fileFd != -1) {
+			sent = sendfile(_fd, chunk.fileFd, &chunk.offset, chunk.remaining);
+			if (sent > 0) {
+				chunk.remaining -= sent;
+				if (!chunk.remaining)
+					popOutput();
+				continue;
+			}
+			if (sent == 0) {
+				std::cerr << "❌ File shrank while sending it on fd " << _fd << std::endl;
+				return -1;
+			}
+		}
+		else {
+			int flags = MSG_NOSIGNAL | (_output.size() > 1 ? MSG_MORE : 0);
+			sent = send(_fd, chunk.data.data() + chunk.offset, chunk.data.size() - chunk.offset, flags);
+			if (sent > 0) {
+				chunk.offset += sent;
+				if ((size_t)chunk.offset == chunk.data.size())
+					popOutput();
+				continue;
+			}
+		}
+		if (sent < 0 && errno == EINTR)
+			continue;
+		if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return 1;
+		std::cerr << "❌ Failed to send response on fd " << _fd << ": " << strerror(errno) << std::endl;
+		return -1;
+	}
+	return 0;
+}
+
+bool	ClientConnection::wantsWrite() const {
+	return _wantWrite;
+}
+
+void	ClientConnection::setWantWrite(bool wantWrite) {
+	_wantWrite = wantWrite;
+}
+
+bool	ClientConnection::keepAlive() const {
+	return _keepAlive;
+}
+
+void	ClientConnection::setKeepAlive(bool keepAlive, int timeout) {
+	_keepAlive = keepAlive;
+	_keepAliveTimeout = timeout;
+}
+
+//returns how many requests this connection has carried, including the current one
+int	ClientConnection::countRequest() {
+	return ++_requestCount;
+}
+
+/*
+Called once a keep-alive response is fully sent: the connection waits (at most
+_keepAliveTimeout) for the next request. The buffer is kept, it may already
+hold the start of the next pipelined request.
+*/
+void	ClientConnection::resetRequest() {
+	_keepAlive = false;
+	_idle = true;
+}
+
+
+void	ClientConnection::clearIdle() {
+	_idle = false;
+}
+
+/*
+Re-arms the timer for what the connection waits on, called after each of its
+events. Header and idle deadlines run from the start of the phase, a client
+trickling bytes can't stretch them. Body and send deadlines restart whenever
+data moves, like nginx's timeouts between two reads or writes. now is in
+monotonicSeconds(), the clock of the loop's TimerWheel.
+*/
+void	ClientConnection::updateTimer(time_t now) {
+	TimerKind kind;
+	int seconds;
+	if (_wantWrite) {
+		kind = TIMER_SEND;
+		seconds = _config->send_timeout;
+	}
+	else if (_idle) {
+		kind = TIMER_IDLE;
+		seconds = _keepAliveTimeout;
+	}
+	else if (_state == READING_HEADERS) {
+		kind = TIMER_HEADER;
+		seconds = _config->client_header_timeout;
+	}
+	else {
+		kind = TIMER_BODY;
+		seconds = _config->client_body_timeout;
+	}
+	if (kind == _timerKind && (kind == TIMER_HEADER || kind == TIMER_IDLE) && _timer.armed())
+		return;
+	_timerKind = kind;
+	_timers->schedule(_timer, now + seconds);
+}
+
+const char*	ClientConnection::timerName() const {
+	switch (_timerKind) {
+		case TIMER_HEADER: return "Header";
+		case TIMER_BODY: return "Body";
+		case TIMER_SEND: return "Send";
+		case TIMER_IDLE: return "Keep-alive";
+		default: return "Connection";
+	}
+}
+
+const GzipPolicy*	ClientConnection::gzip() const {
+	return _gzip;
+}
+
+/*
+The policy belongs to the location of the request being handled, it must be
+reset to NULL before that location goes away.
+*/
+void	ClientConnection::setGzip(const GzipPolicy* gzip) {
+	_gzip = gzip;
+}
@@ -35,6 +35,17 @@ std::vector<std::string> line_splitter(const std::string& line) {
 	return result;
 }
 
+//every limit_req must name a zone that exists, wherever in the file it was declared
+static void	checkLimitReqZones(const std::vector<ServerConfig>& servers, const GlobalConfig& global) {
+	for (size_t i = 0; i < servers.size(); ++i) {
+		for (size_t j = 0; j < servers[i].locations.size(); ++j) {
+			const std::string& zone = servers[i].locations[j].limit_req.zone;
+			if (!zone.empty() && !global.limit_req_zones.count(zone))
+				throw std::runtime_error("Unknown limit_req zone '" + zone + "'");
+		}
+	}
+}
+
 void	ConfigParser::parseFile(const std::string& path) {
 	std::ifstream file(path.c_str());
 	if (!file.is_open()) {
@@ -54,9 +65,20 @@ void	ConfigParser::parseFile(const std::string& path) {
 			servers.push_back(server);
 			continue;
 		}
-		else if (line.find("server") == 0)
+		else if (line.find("server") == 0) {
 			error("Couldn't read server block\n");
+			continue;
+		}
+		//block wrappers like 'http {' or 'events {' only group directives
+		if (line == "}" || line[line.size() - 1] == '{')
+			continue;
+		std::string key, value;
+		if (parseKeyValue(line, key, value)) {
+			global.raw[key] = value;
+			parseGlobalDirective(key, value);
+		}
 	}
+	checkLimitReqZones(servers, global);
 }
 
 void ConfigParser::parseServerBlock(std::ifstream& file, ServerConfig& server) {
@@ -76,29 +98,39 @@ void ConfigParser::parseServerBlock(std::ifstream& file, ServerConfig& server) {
 			if (depth == 0) {
 				convertListenEntriesToPortsAndHost(server);
 				applyDefaults(server);
+				//only now is every server-level directive in, wherever it sat in the block
+				for (size_t i = 0; i < server.locations.size(); ++i)
+					applyInheritance(server.locations[i], server);
+				server.routes.build(server.locations);
+				server.rewrites.compile();
 				return;
 			}
 			continue;
 		}
 		//checks if location and '{' are on same line, but rejects 'location\{' or 'location\{'
-		//like nginx
+		//like nginx, with an optional modifier: 'location = /exact {', 'location ~ \.php$ {'
 		if (line.find("location") == 0) {
 			std::istringstream iss(line);
-			std::string	type, path, brace;
+			std::string	type, modifier, path, brace;
 			iss >> type >> path >> brace;
+			if (path == "=" || path == "~" || path == "~*" || path == "^~") {
+				modifier = path;
+				path = brace;
+				iss >> brace;
+			}
 			if (brace != "{")
 				throw std::runtime_error("Malformed location block: expected space between path and '{', e.g. 'location / {'\n");
 			if (!path.empty()) {
 				LocationConfig	location;
 				location.path = path; //save URL path for location block (upload etc)
+				location.modifier = modifier;
 				parseLocationBlock(file, location);
-				applyInheritance(location, server);
 				for (size_t i = 0; i < server.locations.size(); ++i) {
-					if (server.locations[i].path == location.path) {
+					if (server.locations[i].path == location.path && server.locations[i].modifier == location.modifier) {
 						throw std::runtime_error("Duplicate location block for path: " + location.path);
 					}
 				}
-				if (location.path[0] != '/') {
+				if (location.path[0] != '/' && modifier != "~" && modifier != "~*") {
 					throw std::runtime_error("Location path must start with '/'\n");
 				}
 				server.locations.push_back(location);
@@ -155,13 +187,136 @@ const	std::vector<ServerConfig>& ConfigParser::getServers() const {
 	return servers;
 }
 
+const GlobalConfig& ConfigParser::getGlobal() const {
+	return global;
+}
+
 void	ConfigParser::print() const {
+	global.print();
 	for (size_t i = 0; i < servers.size(); i++) {
 		std::cout << "\n🌸 SERVER " << i + 1 << std::endl;
 		servers[i].print();
 	}
 }
 
+//'512', '64k', '8m' or '1g' to bytes
+static size_t	parseSize(const std::string& value) {
+	char* end;
+	size_t size = std::strtoul(value.c_str(), &end, 10);
+	if (*end == 'k' || *end == 'K')
+		size *= 1024;
+	else if (*end == 'm' || *end == 'M')
+		size *= 1024 * 1024;
+	else if (*end == 'g' || *end == 'G')
+		size *= 1024 * 1024 * 1024;
+	return size;
+}
+
+//'20', '20s', '5m' or '1h' to seconds, anything else is a config error
+static int	parseSeconds(const std::string& value) {
+	char* end;
+	long seconds = std::strtol(value.c_str(), &end, 10);
+	long unit = 1;
+	if (*end == 'm')
+		unit = 60;
+	else if (*end == 'h')
+		unit = 3600;
+	if (*end && (*end == 's' || unit != 1))
+		++end;
+	if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0])) || *end
+		|| seconds > 24 * 3600 * 365 / unit)
+		throw std::runtime_error("Invalid time '" + value + "', expected e.g. 60, 60s, 5m or 1h");
+	return static_cast<int>(seconds * unit);
+}
+
+/*
+limit_req_zone [$binary_remote_addr] zone=api:1m rate=10r/s;  (or r/m)
+Clients are always told apart by address, the key is only there for nginx configs.
+*/
+static void	parseLimitReqZone(const std::string& value, std::map<std::string, LimitReqZoneSpec>& zones) {
+	std::vector<std::string> params = line_splitter(value);
+	std::string name;
+	LimitReqZoneSpec zone;
+	for (size_t i = 0; i < params.size(); ++i) {
+		if (params[i].compare(0, 5, "zone=") == 0) {
+			size_t colon = params[i].find(':');
+			name = params[i].substr(5, colon == std::string::npos ? std::string::npos : colon - 5);
+			if (colon != std::string::npos)
+				zone.size = parseSize(params[i].substr(colon + 1));
+		}
+		else if (params[i].compare(0, 5, "rate=") == 0) {
+			char* end;
+			long rate = std::strtol(params[i].c_str() + 5, &end, 10);
+			std::string unit = end;
+			if (rate <= 0 || rate > 1000000 || (unit != "r/s" && unit != "r/m"))
+				throw std::runtime_error("Invalid limit_req_zone " + params[i] + ", expected e.g. rate=10r/s");
+			zone.rate = unit == "r/s" ? rate * 1000 : rate * 1000 / 60;
+		}
+		else if (params[i] != "$binary_remote_addr" && params[i] != "$remote_addr")
+			throw std::runtime_error("Invalid limit_req_zone parameter '" + params[i] + "'");
+	}
+	if (name.empty())
+		throw std::runtime_error("limit_req_zone needs a zone=name:size");
+	zones[name] = zone;
+}
+
+void	ConfigParser::parseGlobalDirective(const std::string& key, const std::string& value) {
+	if (key == "use") {
+		if (value != "epoll" && value != "poll")
+			throw std::runtime_error("Invalid event backend '" + value + "', expected epoll or poll");
+		global.event_backend = value;
+	}
+	else if (key == "static_cache_size")
+		global.static_cache_size = parseSize(value);
+	else if (key == "static_cache_max_file")
+		global.static_cache_max_file = parseSize(value);
+	else if (key == "gzip_cache_size")
+		global.gzip_cache_size = parseSize(value);
+	else if (key == "worker_processes") {
+		//'auto' is one worker per online core
+		long workers = value == "auto" ? sysconf(_SC_NPROCESSORS_ONLN) : std::atol(value.c_str());
+		if (workers < 1 || workers > 1024)
+			throw std::runtime_error("Invalid worker_processes '" + value + "'");
+		global.worker_processes = static_cast<int>(workers);
+	}
+	else if (key == "worker_threads") {
+		long threads = value == "auto" ? sysconf(_SC_NPROCESSORS_ONLN) : std::atol(value.c_str());
+		if (threads < 1 || threads > 1024)
+			throw std::runtime_error("Invalid worker_threads '" + value + "'");
+		global.worker_threads = static_cast<int>(threads);
+	}
+	else if (key == "thread_balance") {
+		if (value != "round_robin" && value != "least_conn")
+			throw std::runtime_error("Invalid thread_balance '" + value + "', expected round_robin or least_conn");
+		global.least_conn = value == "least_conn";
+	}
+	else if (key == "worker_connections" || key == "limit_conn_per_ip") {
+		char* end;
+		long limit = std::strtol(value.c_str(), &end, 10);
+		if (value.empty() || *end || limit < 0)
+			throw std::runtime_error("Invalid " + key + " '" + value + "'");
+		if (key == "worker_connections")
+			global.worker_connections = static_cast<size_t>(limit);
+		else
+			global.limit_conn_per_ip = static_cast<int>(limit);
+	}
+	else if (key == "shed_target" || key == "shed_interval") {
+		//milliseconds, a trailing "ms" is accepted
+		char* end;
+		long ms = std::strtol(value.c_str(), &end, 10);
+		if (value.empty() || (*end && std::string(end) != "ms") || ms < 0 || ms > 60000)
+			throw std::runtime_error("Invalid " + key + " '" + value + "'");
+		if (key == "shed_target")
+			global.shed_target = static_cast<int>(ms);
+		else
+			global.shed_interval = static_cast<int>(ms);
+	}
+	else if (key == "limit_req_zone")
+		parseLimitReqZone(value, global.limit_req_zones);
+	else
+		error("Unknown global directive: '" + key + "'\n");
+}
+
 void	ConfigParser::parseServerDirective(ServerConfig& server, const std::string& key, const std::string& value) {
 	//store the list of ports as raw data to be converted later
 	if (key == "listen")
@@ -178,6 +333,18 @@ void	ConfigParser::parseServerDirective(ServerConfig& server, const std::string&
 		server.index = value;
 	else if (key == "client_max_body_size")
 		server.client_max_body_size = std::atol(value.c_str());
+	else if (key == "client_max_header_size")
+		server.client_max_header_size = parseSize(value); //'16k'
+	else if (key == "keepalive_timeout")
+		server.keepalive_timeout = parseSeconds(value); //'15', '15s' or '1m', 0 disables keep-alive
+	else if (key == "keepalive_requests")
+		server.keepalive_requests = std::atoi(value.c_str());
+	else if (key == "client_header_timeout")
+		server.client_header_timeout = parseSeconds(value); //'60', '60s' or '1m'
+	else if (key == "client_body_timeout")
+		server.client_body_timeout = parseSeconds(value);
+	else if (key == "send_timeout")
+		server.send_timeout = parseSeconds(value);
 	else if (key == "error_page") {
 		std::istringstream iss(value);
 		int	code;
@@ -190,7 +357,8 @@ void	ConfigParser::parseServerDirective(ServerConfig& server, const std::string&
 		else
 			error("Couldn't read error page\n");
 	}
-	else
+	else if (!parseOpenFileCache(server.open_file_cache, key, value) && !parseGzip(server.gzip, key, value)
+		&& !parseRewrite(server.rewrites, key, value) && !parseLimitReq(server.limit_req, key, value))
 		error("Unknown directive in server block: '" + key + "'\n");
 }
 
@@ -209,6 +377,10 @@ void	ConfigParser::parseLocationDirective(LocationConfig& location, const std::s
 		if (value == "on")
 			location.autoindex = true;
 	}
+	else if (key == "gzip_static")
+		location.gzip_static = (value == "on");
+	else if (key == "brotli_static")
+		location.brotli_static = (value == "on");
 	else if (key == "upload_path")
 		location.upload_path = value;
 	else if (key == "return")
@@ -224,11 +396,147 @@ void	ConfigParser::parseLocationDirective(LocationConfig& location, const std::s
 		else
 			error("Invalid CGI mapping: expected two arguments\n");
 	}
+	else if (parseOpenFileCache(location.open_file_cache, key, value) || parseGzip(location.gzip, key, value)
+		|| parseLimitReq(location.limit_req, key, value))
+		location.overrides.push_back(std::make_pair(key, value)); //replayed by applyInheritance
 	else
 		error("Unknown directive in location block: '" + key + "'\n");
 }
 
+/*
+open_file_cache max=1000 inactive=20s;  (or 'off')
+open_file_cache_valid 60s;
+open_file_cache_errors on;
+Allowed in server and location blocks, returns false for any other directive.
+*/
+bool	ConfigParser::parseOpenFileCache(FileCachePolicy& policy, const std::string& key, const std::string& value) {
+	if (key == "open_file_cache") {
+		policy.max = 0;
+		if (value == "off")
+			return true;
+		std::vector<std::string> params = line_splitter(value);
+		for (size_t i = 0; i < params.size(); ++i) {
+			if (params[i].compare(0, 4, "max=") == 0)
+				policy.max = std::strtoul(params[i].c_str() + 4, NULL, 10);
+			else if (params[i].compare(0, 9, "inactive=") == 0)
+				policy.inactive = parseSeconds(params[i].substr(9));
+			else
+				error("Unknown open_file_cache parameter: '" + params[i] + "'\n");
+		}
+		if (!policy.max)
+			throw std::runtime_error("open_file_cache needs max=N or 'off'");
+	}
+	else if (key == "open_file_cache_valid")
+		policy.valid = parseSeconds(value);
+	else if (key == "open_file_cache_errors")
+		policy.errors = (value == "on");
+	else
+		return false;
+	return true;
+}
+
+/*
+gzip on;
+gzip_types text/html text/css application/javascript;  (or *)
+gzip_min_length 256;
+gzip_max_length 1m;
+gzip_comp_level 6;
+Allowed in server and location blocks, returns false for any other directive.
+*/
+bool	ConfigParser::parseGzip(GzipPolicy& policy, const std::string& key, const std::string& value) {
+	if (key == "gzip")
+		policy.enabled = (value == "on");
+	else if (key == "gzip_types")
+		policy.types = line_splitter(value);
+	else if (key == "gzip_min_length")
+		policy.minLength = parseSize(value);
+	else if (key == "gzip_max_length")
+		policy.maxLength = parseSize(value);
+	else if (key == "gzip_comp_level") {
+		policy.level = std::atoi(value.c_str());
+		if (policy.level < 1 || policy.level > 9)
+			throw std::runtime_error("gzip_comp_level must be between 1 and 9");
+	}
+	else
+		return false;
+	return true;
+}
+
+/*
+rewrite ^/home$ /index.html;
+try_files $uri $uri.html $uri/index.html =404;
+try_files_cache_valid 5s;  (0 turns the probe cache off)
+*/
+bool	ConfigParser::parseRewrite(RewriteEngine& rewrites, const std::string& key, const std::string& value) {
+	if (key == "rewrite") {
+		std::vector<std::string> params = line_splitter(value);
+		if (params.size() != 2)
+			throw std::runtime_error("rewrite expects a regex and a replacement: '" + value + "'");
+		rewrites.addRule(params[0], params[1]);
+	}
+	else if (key == "try_files") {
+		std::vector<std::string> params = line_splitter(value);
+		if (params.size() < 2)
+			throw std::runtime_error("try_files expects at least one file and a fallback: '" + value + "'");
+		const std::string& fallback = params.back();
+		if (fallback[0] == '=') {
+			char* end;
+			long code = std::strtol(fallback.c_str() + 1, &end, 10);
+			if (fallback.size() == 1 || *end || code < 300 || code > 599)
+				throw std::runtime_error("Invalid try_files fallback: '" + fallback + "'");
+		}
+		rewrites.setTryFiles(params);
+	}
+	else if (key == "try_files_cache_valid")
+		rewrites.setProbeTtl(parseSeconds(value));
+	else
+		return false;
+	return true;
+}
+
+/*
+limit_req zone=api burst=20;  (nodelay is accepted, it is the only mode)
+Allowed in server and location blocks, returns false for any other directive.
+*/
+bool	ConfigParser::parseLimitReq(LimitReqPolicy& policy, const std::string& key, const std::string& value) {
+	if (key != "limit_req")
+		return false;
+	std::vector<std::string> params = line_splitter(value);
+	policy = LimitReqPolicy();
+	for (size_t i = 0; i < params.size(); ++i) {
+		if (params[i].compare(0, 5, "zone=") == 0)
+			policy.zone = params[i].substr(5);
+		else if (params[i].compare(0, 6, "burst=") == 0) {
+			char* end;
+			long burst = std::strtol(params[i].c_str() + 6, &end, 10);
+			if (*end || burst < 0 || burst > 100000)
+				throw std::runtime_error("Invalid limit_req " + params[i]);
+			policy.burst = static_cast<int>(burst);
+		}
+		else if (params[i] != "nodelay")
+			throw std::runtime_error("Invalid limit_req parameter '" + params[i] + "'");
+	}
+	if (policy.zone.empty())
+		throw std::runtime_error("limit_req needs a zone=");
+	return true;
+}
+
+/*
+Runs once the whole server block is parsed, so a server-level directive
+written after a location still applies to it. open_file_cache, gzip and
+limit_req start from the server's settings, then the location's own lines
+are applied over them in order.
+*/
 void	ConfigParser::applyInheritance(LocationConfig& location, const ServerConfig& server) {
+	location.open_file_cache = server.open_file_cache;
+	location.gzip = server.gzip;
+	location.limit_req = server.limit_req;
+	for (size_t i = 0; i < location.overrides.size(); ++i) {
+		const std::string& key = location.overrides[i].first;
+		const std::string& value = location.overrides[i].second;
+		if (!parseOpenFileCache(location.open_file_cache, key, value) && !parseGzip(location.gzip, key, value))
+			parseLimitReq(location.limit_req, key, value);
+	}
 	if (!location.root_set)
 		location.root = server.root;
 	if (!location.index_set)
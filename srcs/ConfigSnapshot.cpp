@@ -0,0 +1,140 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ConfigSnapshot.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+ConfigStore g_configs;
+
+ListenAddress::ListenAddress() : port(0) {}
+
+/*
+Groups the server blocks by host:port, each group becomes one listening socket
+whose blocks are told apart by Host. The snapshot starts with one reference,
+the caller's.
+*/
+ConfigSnapshot::ConfigSnapshot(const ConfigParser& parser, unsigned generation)
+	: _parser(parser), _generation(generation), _refs(1) {
+	const std::vector<ServerConfig>& servers = _parser.getServers();
+	for (size_t i = 0; i < servers.size(); ++i) {
+		for (size_t j = 0; j < servers[i].ports.size(); ++j) {
+			int port = servers[i].ports[j];
+			std::string address = servers[i].host + ":" + intToStr(port);
+			ListenAddress& listen = _addresses[address];
+			listen.host = servers[i].host;
+			listen.port = port;
+			if (servers[i].listen_options.count(port))
+				listen.options = servers[i].listen_options.find(port)->second;
+			bool isDefault = std::find(servers[i].default_ports.begin(), servers[i].default_ports.end(), port)
+				!= servers[i].default_ports.end();
+			listen.hosts.add(servers[i], isDefault);
+		}
+	}
+	for (std::map<std::string, ListenAddress>::iterator it = _addresses.begin(); it != _addresses.end(); ++it) {
+		it->second.hosts.setAddress(it->first);
+		it->second.hosts.build();
+	}
+}
+
+ConfigSnapshot::~ConfigSnapshot() {}
+
+void	ConfigSnapshot::retain() {
+	ScopedLock lock(_lock);
+	++_refs;
+}
+
+//the last reference frees the snapshot, on whichever thread drops it
+void	ConfigSnapshot::release() {
+	bool last;
+	{
+		ScopedLock lock(_lock);
+		last = --_refs == 0;
+	}
+	if (last) {
+		if (g_signal != 0) //still serving, so a reload retired it
+			std::cout << "🗑️ Configuration generation " << _generation << " released" << std::endl;
+		delete this;
+	}
+}
+
+const GlobalConfig&	ConfigSnapshot::global() const {
+	return _parser.getGlobal();
+}
+
+const std::map<std::string, ListenAddress>&	ConfigSnapshot::addresses() const {
+	return _addresses;
+}
+
+//NULL when nothing listens on that address in this configuration
+const VirtualHosts*	ConfigSnapshot::hosts(const std::string& address) const {
+	std::map<std::string, ListenAddress>::const_iterator it = _addresses.find(address);
+	if (it == _addresses.end())
+		return NULL;
+	return &it->second.hosts;
+}
+
+unsigned	ConfigSnapshot::generation() const {
+	return _generation;
+}
+
+ConfigStore::ConfigStore() : _current(NULL), _reusePort(false) {}
+
+ConfigStore::~ConfigStore() {
+	clear();
+}
+
+void	ConfigStore::setSource(const std::string& path) {
+	_path = path;
+}
+
+const std::string&	ConfigStore::path() const {
+	return _path;
+}
+
+void	ConfigStore::setReusePort(bool reusePort) {
+	_reusePort = reusePort;
+}
+
+bool	ConfigStore::reusePort() const {
+	return _reusePort;
+}
+
+//takes over the caller's reference, new connections and requests use it from now on
+void	ConfigStore::publish(ConfigSnapshot* snapshot) {
+	ConfigSnapshot* previous;
+	{
+		ScopedLock lock(_lock);
+		previous = _current;
+		_current = snapshot;
+	}
+	if (previous)
+		previous->release();
+}
+
+//a new reference to the current snapshot, the caller releases it
+ConfigSnapshot*	ConfigStore::acquire() {
+	ScopedLock lock(_lock);
+	_current->retain();
+	return _current;
+}
+
+//like acquire(), but NULL while mine is still the current one (the usual case)
+ConfigSnapshot*	ConfigStore::acquireIfNewer(const ConfigSnapshot* mine) {
+	ScopedLock lock(_lock);
+	if (!_current || _current == mine)
+		return NULL;
+	_current->retain();
+	return _current;
+}
+
+void	ConfigStore::clear() {
+	publish(NULL);
+}
@@ -0,0 +1,107 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ConnectionTable.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+static const FdSlot	g_noSlot = {FD_NONE, NULL, NULL};
+
+ConnectionTable::ConnectionTable() : _clients(0) {}
+
+//the owner destroys the connections first (runEventLoop does), their timers belong to its wheel
+ConnectionTable::~ConnectionTable() {
+	destroyClients();
+	for (size_t i = 0; i < _chunks.size(); ++i)
+		::operator delete(_chunks[i]);
+}
+
+//grows the array to reach fd, doubling so a burst of new fds costs few copies
+FdSlot&	ConnectionTable::slot(int fd) {
+	if (static_cast<size_t>(fd) >= _byFd.size())
+		_byFd.resize(std::max(static_cast<size_t>(fd) + 1, _byFd.size() * 2), g_noSlot);
+	return _byFd[fd];
+}
+
+//FD_NONE for anything we don't watch
+const FdSlot&	ConnectionTable::operator[](int fd) const {
+	if (fd < 0 || static_cast<size_t>(fd) >= _byFd.size())
+		return g_noSlot;
+	return _byFd[fd];
+}
+
+void	ConnectionTable::addListener(int fd, ServerSocket* listener) {
+	FdSlot& entry = slot(fd);
+	entry.kind = FD_LISTENER;
+	entry.listener = listener;
+}
+
+void	ConnectionTable::addWakeup(int fd) {
+	slot(fd).kind = FD_WAKEUP;
+}
+
+//forgets a listener or a wake-up fd, clients go through destroyClient()
+void	ConnectionTable::remove(int fd) {
+	if (fd >= 0 && static_cast<size_t>(fd) < _byFd.size() && _byFd[fd].kind != FD_CLIENT)
+		_byFd[fd] = g_noSlot;
+}
+
+//one more chunk of slots, only when every slot so far is in use
+void	ConnectionTable::refill() {
+	char* chunk = static_cast<char*>(::operator new(CHUNK * sizeof(ClientConnection)));
+	_chunks.push_back(chunk);
+	for (size_t i = CHUNK; i > 0; --i)
+		_free.push_back(chunk + (i - 1) * sizeof(ClientConnection));
+}
+
+ClientConnection*	ConnectionTable::createClient(int fd, const sockaddr_in& peer, ConfigSnapshot* snapshot,
+						const VirtualHosts& hosts, TimerWheel& timers) {
+	FdSlot& entry = slot(fd);
+	if (_free.empty())
+		refill();
+	void* storage = _free.back();
+	_free.pop_back();
+	entry.kind = FD_CLIENT;
+	entry.client = new (storage) ClientConnection(fd, peer, snapshot, hosts, timers);
+	++_clients;
+	return entry.client;
+}
+
+//runs the destructor (which closes the socket) and keeps the slot for the next client
+void	ConnectionTable::destroyClient(int fd) {
+	ClientConnection* connection = client(fd);
+	if (!connection)
+		return;
+	_byFd[fd] = g_noSlot;
+	connection->~ClientConnection();
+	_free.push_back(connection);
+	--_clients;
+}
+
+//the listening sockets, for a reload or the shutdown
+void	ConnectionTable::listeners(std::vector<ServerSocket*>& out) const {
+	for (size_t fd = 0; fd < _byFd.size(); ++fd)
+		if (_byFd[fd].kind == FD_LISTENER)
+			out.push_back(_byFd[fd].listener);
+}
+
+ClientConnection*	ConnectionTable::client(int fd) const {
+	const FdSlot& entry = (*this)[fd];
+	return entry.kind == FD_CLIENT ? entry.client : NULL;
+}
+
+size_t	ConnectionTable::clientCount() const {
+	return _clients;
+}
+
+void	ConnectionTable::destroyClients() {
+	for (size_t fd = 0; fd < _byFd.size() && _clients; ++fd)
+		destroyClient(static_cast<int>(fd));
+}
@@ -0,0 +1,197 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   EventBackend.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+/*
+Picks the backend named in the config ("epoll" or "poll").
+If epoll is wanted but the kernel refuses it, we fall back to poll().
+*/
+EventBackend* EventBackend::create(const std::string& preferred) {
+	if (preferred != "poll") {
+		EpollBackend* epoll = new EpollBackend();
+		if (epoll->isValid())
+			return epoll;
+		std::cerr << "⚠️ epoll unavailable, falling back to poll()" << std::endl;
+		delete epoll;
+	}
+	return new PollBackend();
+}
+
+/* ************************************************************************** */
+/*                                   epoll                                    */
+/* ************************************************************************** */
+
+static uint32_t	toEpollFlags(int flags) {
+	uint32_t events = 0;
+	if (flags & EVENT_READ)
+		events |= EPOLLIN;
+	if (flags & EVENT_WRITE)
+		events |= EPOLLOUT;
+	if (flags & EVENT_EDGE)
+		events |= EPOLLET;
+	return events;
+}
+
+EpollBackend::EpollBackend() : _epfd(-1), _events(512) {
+	_epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (_epfd == -1)
+		std::cerr << "❌ epoll_create1 failed: " << strerror(errno) << std::endl;
+}
+
+EpollBackend::~EpollBackend() {
+	if (_epfd != -1)
+		close(_epfd);
+}
+
+bool	EpollBackend::isValid() const {
+	return _epfd != -1;
+}
+
+bool	EpollBackend::add(int fd, int flags) {
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = toEpollFlags(flags);
+	ev.data.fd = fd;
+	if (epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+		std::cerr << "❌ epoll_ctl ADD failed for fd " << fd << ": " << strerror(errno) << std::endl;
+		return false;
+	}
+	return true;
+}
+
+bool	EpollBackend::modify(int fd, int flags) {
+	struct epoll_event ev;
+	std::memset(&ev, 0, sizeof(ev));
+	ev.events = toEpollFlags(flags);
+	ev.data.fd = fd;
+	if (epoll_ctl(_epfd, EPOLL_CTL_MOD, fd, &ev) == -1) {
+		std::cerr << "❌ epoll_ctl MOD failed for fd " << fd << ": " << strerror(errno) << std::endl;
+		return false;
+	}
+	return true;
+}
+
+//closing an fd removes it from epoll anyway, this just keeps things explicit
+void	EpollBackend::remove(int fd) {
+	epoll_ctl(_epfd, EPOLL_CTL_DEL, fd, NULL);
+}
+
+int	EpollBackend::wait(std::vector<IoEvent>& ready, int timeoutMs) {
+	ready.clear();
+	int n = epoll_wait(_epfd, &_events[0], _events.size(), timeoutMs);
+	if (n <= 0)
+		return n;
+	for (int i = 0; i < n; ++i) {
+		IoEvent event;
+		event.fd = _events[i].data.fd;
+		event.flags = 0;
+		if (_events[i].events & EPOLLIN)
+			event.flags |= EVENT_READ;
+		if (_events[i].events & EPOLLOUT)
+			event.flags |= EVENT_WRITE;
+		if (_events[i].events & (EPOLLERR | EPOLLHUP))
+			event.flags |= EVENT_ERROR;
+		ready.push_back(event);
+	}
+	//a full batch means we are busy, let the next wait return more at once
+	if (n == (int)_events.size())
+		_events.resize(_events.size() * 2);
+	return n;
+}
+
+const char*	EpollBackend::name() const {
+	return "epoll";
+}
+
+/* ************************************************************************** */
+/*                                    poll                                    */
+/* ************************************************************************** */
+
+PollBackend::PollBackend() {}
+
+PollBackend::~PollBackend() {}
+
+static short	toPollFlags(int flags) {
+	short events = 0;
+	if (flags & EVENT_READ)
+		events |= POLLIN;
+	if (flags & EVENT_WRITE)
+		events |= POLLOUT;
+	return events;
+}
+
+bool	PollBackend::add(int fd, int flags) {
+	if (fd < 0)
+		return false;
+	if ((size_t)fd >= _index.size())
+		_index.resize(fd + 1, -1);
+	if (_index[fd] != -1)
+		return modify(fd, flags);
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = toPollFlags(flags);
+	pfd.revents = 0;
+	_index[fd] = _fds.size();
+	_fds.push_back(pfd);
+	return true;
+}
+
+bool	PollBackend::modify(int fd, int flags) {
+	if (fd < 0 || (size_t)fd >= _index.size() || _index[fd] == -1)
+		return false;
+	_fds[_index[fd]].events = toPollFlags(flags);
+	return true;
+}
+
+//swap the last pollfd into the freed slot so removal stays O(1)
+void	PollBackend::remove(int fd) {
+	if (fd < 0 || (size_t)fd >= _index.size() || _index[fd] == -1)
+		return;
+	int slot = _index[fd];
+	int last = _fds.size() - 1;
+	if (slot != last) {
+		_fds[slot] = _fds[last];
+		_index[_fds[slot].fd] = slot;
+	}
+	_fds.pop_back();
+	_index[fd] = -1;
+}
+
+int	PollBackend::wait(std::vector<IoEvent>& ready, int timeoutMs) {
+	ready.clear();
+	//with nothing registered poll() still sleeps for the timeout, the caller must not spin
+	int n = poll(_fds.empty() ? NULL : &_fds[0], _fds.size(), timeoutMs);
+	if (n <= 0)
+		return n;
+	//collect first: the caller may add or remove fds while handling events
+	for (size_t i = 0; i < _fds.size() && (int)ready.size() < n; ++i) {
+		short revents = _fds[i].revents;
+		if (!revents)
+			continue;
+		IoEvent event;
+		event.fd = _fds[i].fd;
+		event.flags = 0;
+		if (revents & POLLIN)
+			event.flags |= EVENT_READ;
+		if (revents & POLLOUT)
+			event.flags |= EVENT_WRITE;
+		if (revents & (POLLERR | POLLHUP | POLLNVAL))
+			event.flags |= EVENT_ERROR;
+		ready.push_back(event);
+	}
+	return ready.size();
+}
+
+const char*	PollBackend::name() const {
+	return "poll";
+}
@@ -0,0 +1,34 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   GlobalConfig.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+GlobalConfig::GlobalConfig() : event_backend("epoll"), static_cache_size(0), static_cache_max_file(65536),
+	gzip_cache_size(0), worker_processes(1), worker_threads(1), least_conn(false),
+	worker_connections(1024), limit_conn_per_ip(0), shed_target(50), shed_interval(500) {}
+
+void	GlobalConfig::print() const {
+	std::cout << "\n🌍 GLOBAL" << std::endl;
+	std::cout << "use: " << event_backend << std::endl;
+	std::cout << "static_cache_size: " << static_cache_size << std::endl;
+	std::cout << "static_cache_max_file: " << static_cache_max_file << std::endl;
+	std::cout << "gzip_cache_size: " << gzip_cache_size << std::endl;
+	std::cout << "worker_processes: " << worker_processes << std::endl;
+	std::cout << "worker_threads: " << worker_threads << (least_conn ? " least_conn" : " round_robin") << std::endl;
+	std::cout << "worker_connections: " << worker_connections << std::endl;
+	std::cout << "limit_conn_per_ip: " << limit_conn_per_ip << std::endl;
+	std::cout << "shed_target: " << shed_target << "ms over " << shed_interval << "ms" << std::endl;
+	std::map<std::string, LimitReqZoneSpec>::const_iterator it = limit_req_zones.begin();
+	for (; it != limit_req_zones.end(); ++it)
+		std::cout << "limit_req_zone " << it->first << ": " << it->second.size << " bytes, "
+			<< it->second.rate << " requests per 1000s" << std::endl;
+}
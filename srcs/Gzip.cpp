@@ -0,0 +1,50 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Gzip.cpp                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+#include <zlib.h>
+
+GzipPolicy::GzipPolicy() : enabled(false), level(6), minLength(256), maxLength(1024 * 1024) {
+	types.push_back("text/html");
+}
+
+bool	GzipPolicy::matchesType(const std::string& contentType) const {
+	for (size_t i = 0; i < types.size(); ++i) {
+		if (types[i] == "*" || types[i] == contentType)
+			return true;
+	}
+	return false;
+}
+
+bool	GzipPolicy::applies(const std::string& contentType, size_t size) const {
+	return enabled && size >= minLength && matchesType(contentType);
+}
+
+/*
+Compresses data into a complete gzip stream (windowBits 15 + 16 asks zlib for
+the gzip header and trailer instead of a raw zlib one).
+*/
+bool	gzipCompress(const char* data, size_t size, int level, std::string& out) {
+	z_stream stream;
+	std::memset(&stream, 0, sizeof(stream));
+	if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		return false;
+	out.resize(deflateBound(&stream, size));
+	stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+	stream.avail_in = size;
+	stream.next_out = reinterpret_cast<Bytef*>(&out[0]);
+	stream.avail_out = out.size();
+	int status = deflate(&stream, Z_FINISH);
+	out.resize(stream.total_out);
+	deflateEnd(&stream);
+	return status == Z_STREAM_END;
+}
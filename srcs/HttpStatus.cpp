@@ -12,36 +12,33 @@
 
 #include "WebServ.hpp"
 
-const std::map<int, std::string>& HttpStatus::statusMessages() {
-	static std::map<int, std::string> statusList;
-	if (statusList.empty()) {
-		statusList[200] = "OK";
-		statusList[201] = "Created";
-		statusList[204] = "No Content";
-		statusList[301] = "Moved Permanently";
-		statusList[302] = "Found";
-		statusList[400] = "Bad Request";
-		statusList[401] = "Unauthorized";
-		statusList[403] = "Forbidden";
-		statusList[404] = "Not Found";
-		statusList[405] = "Method Not Allowed";
-		statusList[409] = "Conflict";
-		statusList[413] = "Payload Too Large";
-		statusList[500] = "Internal Server Error";
-		statusList[501] = "Not Implemented";
-		statusList[502] = "Bad Gateway";
-		statusList[503] = "Service Unavailable";
+/*
+A switch over constant strings: nothing is built at runtime, so every reactor
+thread may look a reason phrase up at the same time without a lock.
+*/
+std::string HttpStatus::getStatusMessages(int code) {
+	switch (code) {
+		case 200: return "OK";
+		case 201: return "Created";
+		case 204: return "No Content";
+		case 206: return "Partial Content";
+		case 301: return "Moved Permanently";
+		case 302: return "Found";
+		case 304: return "Not Modified";
+		case 400: return "Bad Request";
+		case 401: return "Unauthorized";
+		case 403: return "Forbidden";
+		case 404: return "Not Found";
+		case 405: return "Method Not Allowed";
+		case 409: return "Conflict";
+		case 413: return "Payload Too Large";
+		case 416: return "Range Not Satisfiable";
+		case 429: return "Too Many Requests";
+		case 431: return "Request Header Fields Too Large";
+		case 500: return "Internal Server Error";
+		case 501: return "Not Implemented";
+		case 502: return "Bad Gateway";
+		case 503: return "Service Unavailable";
+		default: return "Unknown Status";
 	}
-	return statusList;
 }
-
-std::string HttpStatus::getStatusMessages(int code) {
-	//this line pulls/gets the list of messages (per above)
-	const std::map<int, std::string>& messages = statusMessages();
-	//iterate through the map to find the corresponding code and message
-
-	std::map<int, std::string>::const_iterator it = messages.find(code);
-	if (it != messages.end())
-		return it->second.c_str();
-	return "Unknown Status";
-}
\ No newline at end of file
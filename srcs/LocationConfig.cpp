@@ -12,21 +12,29 @@
 
 #include "WebServ.hpp"
 
-LocationConfig::LocationConfig() : returnStatusCode(0), autoindex(false), root_set(false), index_set(false) {}
+LocationConfig::LocationConfig() : returnStatusCode(0), autoindex(false), gzip_static(false), brotli_static(false),
+	root_set(false), index_set(false) {}
 
 void	LocationConfig::print() const {
 	std::cout << "\nLOCATION:\n";
-	std::cout << "path: " << path << std::endl;
+	std::cout << "path: " << (modifier.empty() ? "" : modifier + " ") << path << std::endl;
 	std::cout << "root: " << root << std::endl;
 	std::cout << "index: " << index << std::endl;
 	std::cout << "return Status Code: " << returnStatusCode << std::endl;
 	std::cout << "redirect: " << redirect << std::endl;
 	std::cout << "autoindex: " << autoindex << std::endl;
+	std::cout << "gzip_static: " << gzip_static << " brotli_static: " << brotli_static << std::endl;
+	std::cout << "gzip: " << gzip.enabled << " level=" << gzip.level << " min_length=" << gzip.minLength
+		<< " types=" << gzip.types.size() << std::endl;
+	if (!limit_req.zone.empty())
+		std::cout << "limit_req: zone=" << limit_req.zone << " burst=" << limit_req.burst << std::endl;
 	std::cout << "methods: ";
 	for (size_t i = 0; i < methods.size(); i++)
 		std::cout << methods[i] << " ";
 	std::cout << std::endl;
 	std::cout << "upload_path: " << upload_path << std::endl;
+	std::cout << "open_file_cache: max=" << open_file_cache.max << " inactive=" << open_file_cache.inactive
+		<< "s valid=" << open_file_cache.valid << "s errors=" << open_file_cache.errors << std::endl;
 
 	for (std::map<std::string, std::string>::const_iterator it = cgi_paths.begin(); it != cgi_paths.end(); ++it) {
 		std::cout << "cgi[" << it->first << "] = " << it->second << std::endl;
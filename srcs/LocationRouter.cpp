@@ -0,0 +1,181 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   LocationRouter.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+LocationRouter::Node::Node() : location(-1), stopRegex(false) {}
+
+LocationRouter::LocationRouter() : _nodes(1) {}
+
+//regex_t can't be copied, the copy compiles its own from the patterns
+LocationRouter::LocationRouter(const LocationRouter& other)
+	: _exact(other._exact), _nodes(other._nodes), _regexes(other._regexes) {
+	compileRegexes();
+}
+
+LocationRouter& LocationRouter::operator=(const LocationRouter& other) {
+	if (this != &other) {
+		freeRegexes();
+		_exact = other._exact;
+		_nodes = other._nodes;
+		_regexes = other._regexes;
+		compileRegexes();
+	}
+	return *this;
+}
+
+LocationRouter::~LocationRouter() {
+	freeRegexes();
+}
+
+void	LocationRouter::compileRegexes() {
+	for (size_t i = 0; i < _regexes.size(); ++i) {
+		_regexes[i].compiled = new regex_t;
+		int flags = REG_EXTENDED | REG_NOSUB | (_regexes[i].icase ? REG_ICASE : 0);
+		if (regcomp(_regexes[i].compiled, _regexes[i].pattern.c_str(), flags) != 0) {
+			std::string pattern = _regexes[i].pattern;
+			delete _regexes[i].compiled;
+			_regexes.resize(i);
+			throw std::runtime_error("Invalid location regex: " + pattern);
+		}
+	}
+}
+
+void	LocationRouter::freeRegexes() {
+	for (size_t i = 0; i < _regexes.size(); ++i) {
+		if (_regexes[i].compiled) {
+			regfree(_regexes[i].compiled);
+			delete _regexes[i].compiled;
+			_regexes[i].compiled = NULL;
+		}
+	}
+}
+
+static bool	compareKey(const std::pair<std::string, size_t>& entry, const std::string& key) {
+	return entry.first < key;
+}
+
+//the child for segment, created if needed (only while building)
+size_t	LocationRouter::addChild(size_t node, const std::string& segment) {
+	Table& children = _nodes[node].children;
+	Table::iterator it = std::lower_bound(children.begin(), children.end(), segment, compareKey);
+	if (it != children.end() && it->first == segment)
+		return it->second;
+	size_t child = _nodes.size();
+	children.insert(it, std::make_pair(segment, child));
+	_nodes.push_back(Node()); //may move children, it is not used after this
+	return child;
+}
+
+void	LocationRouter::build(const std::vector<LocationConfig>& locations) {
+	freeRegexes();
+	_exact.clear();
+	_nodes.assign(1, Node());
+	_regexes.clear();
+
+	for (size_t i = 0; i < locations.size(); ++i) {
+		const LocationConfig& location = locations[i];
+		if (location.modifier == "=") {
+			Table::iterator it = std::lower_bound(_exact.begin(), _exact.end(), location.path, compareKey);
+			_exact.insert(it, std::make_pair(location.path, i));
+		}
+		else if (location.modifier == "~" || location.modifier == "~*") {
+			RegexRoute route;
+			route.pattern = location.path;
+			route.icase = (location.modifier == "~*");
+			route.location = i;
+			route.compiled = NULL;
+			_regexes.push_back(route);
+		}
+		else {
+			size_t node = 0;
+			size_t pos = 0;
+			while (pos < location.path.size()) {
+				size_t end = location.path.find('/', pos);
+				if (end == std::string::npos)
+					end = location.path.size();
+				if (end > pos)
+					node = addChild(node, location.path.substr(pos, end - pos));
+				pos = end + 1;
+			}
+			_nodes[node].location = i;
+			_nodes[node].stopRegex = (location.modifier == "^~");
+		}
+	}
+	compileRegexes();
+}
+
+//three-way compare of a table key with the slice [data, data + size)
+static int	compareSlice(const std::string& key, const char* data, size_t size) {
+	int cmp = std::memcmp(key.data(), data, std::min(key.size(), size));
+	if (cmp)
+		return cmp;
+	return (key.size() < size) ? -1 : (key.size() > size);
+}
+
+//binary search without building a std::string for the key
+static const std::pair<std::string, size_t>*	findSlice(const std::vector<std::pair<std::string, size_t> >& table,
+													const char* data, size_t size) {
+	size_t low = 0;
+	size_t high = table.size();
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		int cmp = compareSlice(table[mid].first, data, size);
+		if (cmp == 0)
+			return &table[mid];
+		if (cmp < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return NULL;
+}
+
+/*
+Walks the request path once, segment by segment, and allocates nothing.
+Returns NULL when no location matches.
+*/
+const LocationConfig*	LocationRouter::match(const std::string& path,
+							const std::vector<LocationConfig>& locations) const {
+	const std::pair<std::string, size_t>* exact = findSlice(_exact, path.data(), path.size());
+	if (exact)
+		return &locations[exact->second];
+
+	int best = _nodes[0].location;
+	bool stopRegex = _nodes[0].stopRegex;
+	size_t node = 0;
+	size_t pos = 0;
+	while (pos < path.size()) {
+		size_t end = path.find('/', pos);
+		if (end == std::string::npos)
+			end = path.size();
+		if (end > pos) {
+			const std::pair<std::string, size_t>* child = findSlice(_nodes[node].children, path.data() + pos, end - pos);
+			if (!child)
+				break;
+			node = child->second;
+			if (_nodes[node].location != -1) {
+				best = _nodes[node].location;
+				stopRegex = _nodes[node].stopRegex;
+			}
+		}
+		pos = end + 1;
+	}
+
+	if (!stopRegex) {
+		for (size_t i = 0; i < _regexes.size(); ++i) {
+			if (regexec(_regexes[i].compiled, path.c_str(), 0, NULL, 0) == 0)
+				return &locations[_regexes[i].location];
+		}
+	}
+	return best == -1 ? NULL : &locations[best];
+}
@@ -12,7 +12,7 @@
 
 #include "WebServ.hpp"
 
-void handleGet(int fd, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
+void handleGet(ClientConnection& client, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
 	std::cout << "📥 Handling GET request for " << path << std::endl;
 
 
@@ -21,57 +21,58 @@ void handleGet(int fd, const std::string& path, const LocationConfig& location,
 	std::cout << "🔧 DEBUG: fullPath = '" << fullPath << "'" << std::endl;
 
 
-	if (isDirectory(fullPath)) {
+	FileInfo info;
+	g_openFileCache.stat(fullPath, location.open_file_cache, info);
+	if (info.isDir) {
 		std::cout << "📁 Path is directory" << std::endl;
 		if (location.autoindex) {
 			std::cout << "📁 Serving directory listing for " << path << std::endl;
 			// For now, send a simple directory listing instead of complex function
 			std::string body = generateSimpleDirectoryListing(fullPath, path);
-			sendHtmlResponse(fd, 200, body);
+			sendHtmlResponse(client, 200, body);
 		} else {
 			// Try to serve index file
 			std::string indexPath = fullPath + "/" + config.index;
-			if (fileExists(indexPath)) {
-				serveStaticFile(indexPath, fd, config);
+			if (g_openFileCache.stat(indexPath, location.open_file_cache, info)) {
+				serveStaticFile(indexPath, client, req, location, config);
 			} else {
 				std::cout << "❌ Directory access forbidden: " << path << std::endl;
 				std::string body = getErrorPageBody(403, config);
-				sendHtmlResponse(fd, 403, body);
+				sendHtmlResponse(client, 403, body);
 			}
 		}
 	} else{
 		// Serve static file
 		std::cout << "📄 Calling serveStaticFile for: " << path << std::endl;
-		serveStaticFile(path, fd, config);
+		serveStaticFile(path, client, req, location, config);
 		std::cout << "✅ serveStaticFile call completed" << std::endl;
 	}
 }
 
-void handlePost(int fd, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
+void handlePost(ClientConnection& client, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
 	std::cout << "📤 Handling POST request for " << path << std::endl;
 
 	(void)location; // Suppress unused warning, as location is not used in this example
 	// Check if this is a file upload
 	if (path == "/upload" || path.find("/upload") == 0) {
-		// Simple file upload handling - you can expand this
-		std::string rawRequest = req.getRawRequest();
-		handleSimpleUpload(rawRequest, fd, config);
+		// The body was streamed to disk while it arrived, see openUploadStream
+		handleSimpleUpload(client, config);
 		return;
 	}
 
 	// Check if this is a CGI script
 	if (path.find("/cgi-bin/") == 0) {
 		// Simple CGI execution - you can expand this
-		handleSimpleCGI(fd, req, path, config);
+		handleSimpleCGI(client, req, path, config);
 		return;
 	}
 
 	// Default POST handling
 	std::string body = "POST request received for: " + path;
-	sendHtmlResponse(fd, 200, body);
+	sendHtmlResponse(client, 200, body);
 }
 
-void handlePut(int fd, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
+void handlePut(ClientConnection& client, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
 	std::cout << "📝 Handling PUT request for " << path << std::endl;
 
 	// Extract filename from path
@@ -92,35 +93,38 @@ void handlePut(int fd, const Request& req, const std::string& path, const Locati
 	if (filename.find("..") != std::string::npos || filename.find("/") != std::string::npos) {
 		std::cout << "❌ Invalid filename in PUT request: " << filename << std::endl;
 		std::string body = getErrorPageBody(400, config);
-		sendHtmlResponse(fd, 400, body);
+		sendHtmlResponse(client, 400, body);
 		return;
 	}
 
 	// Create upload directory if it doesn't exist
 	createDirectoryIfNotExists(uploadPath);
 
-	// Write file content
-	std::string body = req.getBody();
+	// Write file content straight from the receive buffer
 	std::ofstream file(fullPath.c_str(), std::ios::binary);
 
 	if (!file.is_open()) {
 		std::cout << "❌ Cannot create file: " << fullPath << std::endl;
 		std::string errorBody = getErrorPageBody(500, config);
-		sendHtmlResponse(fd, 500, errorBody);
+		sendHtmlResponse(client, 500, errorBody);
 		return;
 	}
 
-	file.write(body.c_str(), body.size());
+	file.write(req.getBodyData(), req.getBodySize());
 	file.close();
+	g_openFileCache.invalidate(fullPath);
+	g_responseCache.invalidate(fullPath);
+	g_gzipCache.invalidate(fullPath);
+	config.rewrites.invalidate(fullPath, config.root);
 
-	std::cout << "✅ File uploaded via PUT: " << fullPath << " (" << body.size() << " bytes)" << std::endl;
+	std::cout << "✅ File uploaded via PUT: " << fullPath << " (" << req.getBodySize() << " bytes)" << std::endl;
 
 	// Send success response
 	std::string responseBody = "File uploaded successfully: " + filename;
-	sendHtmlResponse(fd, 201, responseBody); // 201 Created
+	sendHtmlResponse(client, 201, responseBody); // 201 Created
 }
 
-void handleDelete(int fd, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
+void handleDelete(ClientConnection& client, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
 	std::cout << "🗑️ Handling DELETE request for " << path << std::endl;
 
 	// Extract filename from path
@@ -141,7 +145,7 @@ void handleDelete(int fd, const std::string& path, const LocationConfig& locatio
 	if (filename.find("..") != std::string::npos || filename.find("/") != std::string::npos) {
 		std::cout << "❌ Invalid filename in DELETE request: " << filename << std::endl;
 		std::string body = getErrorPageBody(400, config);
-		sendHtmlResponse(fd, 400, body);
+		sendHtmlResponse(client, 400, body);
 		return;
 	}
 
@@ -149,7 +153,7 @@ void handleDelete(int fd, const std::string& path, const LocationConfig& locatio
 	if (!fileExists(fullPath)) {
 		std::cout << "❌ File not found for deletion: " << fullPath << std::endl;
 		std::string body = getErrorPageBody(404, config);
-		sendHtmlResponse(fd, 404, body);
+		sendHtmlResponse(client, 404, body);
 		return;
 	}
 
@@ -157,18 +161,22 @@ void handleDelete(int fd, const std::string& path, const LocationConfig& locatio
 	if (std::remove(fullPath.c_str()) != 0) {
 		std::cout << "❌ Failed to delete file: " << fullPath << std::endl;
 		std::string body = getErrorPageBody(500, config);
-		sendHtmlResponse(fd, 500, body);
+		sendHtmlResponse(client, 500, body);
 		return;
 	}
 
+	g_openFileCache.invalidate(fullPath);
+	g_responseCache.invalidate(fullPath);
+	g_gzipCache.invalidate(fullPath);
+	config.rewrites.invalidate(fullPath, config.root);
 	std::cout << "✅ File deleted: " << fullPath << std::endl;
 
 	// Send success response
 	std::string responseBody = "File deleted successfully: " + filename;
-	sendHtmlResponse(fd, 200, responseBody); // 200 OK
+	sendHtmlResponse(client, 200, responseBody); // 200 OK
 }
 
-void handleHead(int fd, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
+void handleHead(ClientConnection& client, const Request& req, const std::string& path, const LocationConfig& location, const ServerConfig& config) {
 	std::cout << "📋 Handling HEAD request for " << path << std::endl;
 	//for now
 	(void)config;  // Add this line to suppress warning
@@ -176,30 +184,29 @@ void handleHead(int fd, const std::string& path, const LocationConfig& location,
 	// HEAD is like GET but without the response body
 	std::string fullPath = location.root + path;
 
-	if (!fileExists(fullPath)) {
+	// Size comes from the open file cache, the file itself is never opened
+	FileInfo info;
+	if (!g_openFileCache.stat(fullPath, location.open_file_cache, info)) {
 		// Send 404 headers only (no body)
-		std::string headers = Response::buildHeader(404, 0, "text/html");
-		send(fd, headers.c_str(), headers.size(), 0);
+		std::string headers = Response::buildHeader(404, 0, "text/html", client.keepAlive());
+		client.queueOutput(headers);
 		return;
 	}
 
-	// Get file info
-	std::ifstream file(fullPath.c_str(), std::ios::binary | std::ios::ate);
-	if (!file.is_open()) {
-		std::string headers = Response::buildHeader(500, 0, "text/html");
-		send(fd, headers.c_str(), headers.size(), 0);
+	if (isNotModified(req, info)) {
+		sendNotModified(client, info);
 		return;
 	}
 
-	size_t fileSize = file.tellg();
-	file.close();
+	size_t fileSize = info.size;
 
 	// Determine content type
 	std::string contentType = Response::getContentType(fullPath);
 
 	// Send headers only (no body for HEAD request)
-	std::string headers = Response::buildHeader(200, fileSize, contentType);
-	send(fd, headers.c_str(), headers.size(), 0);
+	std::string headers = Response::buildHeader(200, fileSize, contentType, client.keepAlive(),
+		"Accept-Ranges: bytes\r\n" + validatorHeaders(info));
+	client.queueOutput(headers);
 
 	std::cout << "✅ HEAD response sent for " << path << " (size: " << fileSize << ")" << std::endl;
 }
@@ -281,119 +288,83 @@ std::string generateSimpleDirectoryListing(const std::string& dirPath, const std
 	return html.str();
 }
 
-std::string rewriteURL(const std::string& path, const ServerConfig& config, const std::string& method) {
-	std::cout << "🔄 Rewriting URL: " << path << " with method: " << method << std::endl;
+/*
+Maps a GET path to the file that answers it: the server's rewrite rules first,
+then its try_files list. status is set when try_files ends in '=code'.
+*/
+std::string rewriteURL(const std::string& path, const ServerConfig& config, int& status) {
+	status = 0;
 
 	// Handle root path
 	if (path == "/") {
 		return "/" + config.index;
 	}
 
-	// For POST requests to /upload, don't rewrite
-	if (method == "POST" && path == "/upload") {
-		return path;
-	}
-
-	// URL mapping for clean URLs
-	std::map<std::string, std::string> urlMap;
-	urlMap["/home"] = "/index.html";
-	urlMap["/gallery"] = "/gallery.html";
-	urlMap["/upload"] = "/upload.html";
-	urlMap["/interactive"] = "/interactive.html";
-	urlMap["/cookies"] = "/cookie-demo.html";
-	urlMap["/about"] = "/about.html";
-	urlMap["/contact"] = "/contact.html";
-	urlMap["/error"] = "/error/404.html";
-	urlMap["/help"] = "/help.html";
-
-	// Check if this is a clean URL that needs rewriting
-	std::map<std::string, std::string>::const_iterator it = urlMap.find(path);
-	if (it != urlMap.end()) {
-		return it->second;
-	}
-
-	// Handle directory-style URLs (without trailing slash)
-	std::string pathWithSlash = path + "/";
-	it = urlMap.find(pathWithSlash);
-	if (it != urlMap.end()) {
-		return it->second;
-	}
-
-	// Check if file exists as-is (for files with extensions)
-	std::string fullPath = config.root + path;
-	if (fileExists(fullPath)) {
-		return path; // File exists, use as-is
-	}
-
-	// Try adding .html extension
-	std::string htmlPath = path + ".html";
-	std::string fullHtmlPath = config.root + htmlPath;
-	if (fileExists(fullHtmlPath)) {
-		return htmlPath;
-	}
-
-	// Try as directory with index.html
-	std::string indexPath = path + "/index.html";
-	std::string fullIndexPath = config.root + indexPath;
-	if (fileExists(fullIndexPath)) {
-		return indexPath;
-	}
+	std::string uri = config.rewrites.rewrite(path);
+	if (uri != path)
+		return uri;
 
-	// Return original path if no rewrite rule found
-	return path;
+	// The probes go through the open file cache, and their outcome is kept a few seconds
+	return config.rewrites.tryFiles(path, config.root, config.open_file_cache, status);
 }
 
-void handleSimpleUpload(const std::string& request, int client_fd, const ServerConfig& config) {
-	std::cout << "🚀 Starting file upload process..." << std::endl;
-
-	// Step 1: Extract filename
-	std::string filename;
-	if (!extractFilenameFromRequest(request, filename)) {
-		std::cerr << "❌ Failed to extract filename" << std::endl;
-		sendHtmlResponse(client_fd, 400, getErrorPageBody(400, config));
-		return;
-	}
-	std::cout << "📁 Extracted filename: " << filename << std::endl;
-
-	// Step 2: Find content boundaries
-	size_t contentStart, contentEnd;
-	if (!findFileContentBoundaries(request, filename, contentStart, contentEnd)) {
-		std::cerr << "❌ Failed to find content boundaries" << std::endl;
-		sendHtmlResponse(client_fd, 400, getErrorPageBody(400, config));
-		return;
-	}
-
-	size_t contentLength = contentEnd - contentStart;
-	std::cout << "📏 Content length: " << contentLength << " bytes" << std::endl;
+/*
+Called by the connection as soon as a request's headers are in. Multipart POSTs
+to /upload (the same rule handlePost uses) get their body streamed straight to
+disk while it arrives, everything else returns NULL and is buffered as usual.
+*/
+MultipartParser* openUploadStream(const Request& head, const ServerConfig& config) {
+	std::string path = head.getPath();
+	if (head.getMethod() != "POST" || path.find("/upload") != 0)
+		return NULL;
+	std::string contentType = head.getHeader("content-type");
+	if (contentType.find("multipart/form-data") == std::string::npos)
+		return NULL;
+	const LocationConfig* location = matchLocation(path, config);
+	if (!location || std::find(location->methods.begin(), location->methods.end(), "POST") == location->methods.end())
+		return NULL;
+	std::string boundary = extractBoundary(contentType);
+	if (boundary.empty())
+		return NULL;
+	std::cout << "🚀 Starting streamed file upload..." << std::endl;
+	return new MultipartParser(boundary, config.root + "/upload", config.client_max_body_size);
+}
 
-	// Step 3: Validate file size
-	if (!validateUploadFileSize(contentLength, config)) {
-		std::cerr << "❌ File too large: " << contentLength << " bytes" << std::endl;
-		sendHtmlResponse(client_fd, 413, getErrorPageBody(413, config));
+/*
+By the time the request is dispatched its body has already been written to disk
+by the connection's MultipartParser, we only report how that went.
+*/
+void handleSimpleUpload(ClientConnection& client, const ServerConfig& config) {
+	MultipartParser* upload = client.getUpload();
+	if (!upload) {
+		std::cerr << "❌ Upload is not multipart/form-data" << std::endl;
+		sendHtmlResponse(client, 400, getErrorPageBody(400, config));
 		return;
 	}
-	std::cout << "✅ File size validation passed" << std::endl;
-
-	// Step 4: Save file to server
-	std::string filePath = config.root + "/upload/" + filename;
-	if (!writeFileToServer(request, contentStart, contentLength, filePath)) {
-		std::cerr << "❌ Failed to save file to: " << filePath << std::endl;
-		sendHtmlResponse(client_fd, 500, getErrorPageBody(500, config));
+	if (!upload->finish()) {
+		int status = upload->errorStatus();
+		sendHtmlResponse(client, status, getErrorPageBody(status, config));
 		return;
 	}
-	std::cout << "✅ File saved successfully: " << filePath << std::endl;
-
-	// Step 5: Send success response
-	std::string successResponse = loadAndProcessSuccessTemplate(config, filename);
-	sendHtmlResponse(client_fd, 200, successResponse);
+	//finish() renamed the new file over the old one, cached fds and bodies are of the old one
+	const std::string& savedPath = upload->path();
+	g_openFileCache.invalidate(savedPath);
+	g_responseCache.invalidate(savedPath);
+	g_gzipCache.invalidate(savedPath);
+	config.rewrites.invalidate(savedPath, config.root);
+	std::cout << "✅ File saved successfully: " << upload->filename()
+			<< " (" << upload->fileSize() << " bytes)" << std::endl;
+
+	std::string successResponse = loadAndProcessSuccessTemplate(config, upload->filename());
+	sendHtmlResponse(client, 200, successResponse);
 	
 	std::cout << "📤 Success response sent!" << std::endl;
 }
 
-void handleSimpleCGI(int fd, const Request& req, const std::string& path, const ServerConfig& config) {
+void handleSimpleCGI(ClientConnection& client, const Request& req, const std::string& path, const ServerConfig& config) {
 	std::string method = req.getMethod();
 	std::string query = req.getQuery();
-	std::string body = req.getBody();
+	size_t bodySize = req.getBodySize();
 
 	// Simple CGI response
 	std::ostringstream response;
@@ -408,15 +379,15 @@ void handleSimpleCGI(int fd, const Request& req, const std::string& path, const
 		response << "<p><strong>Query:</strong> " << query << "</p>\n";
 	}
 
-	if (!body.empty()) {
-		response << "<p><strong>Body Size:</strong> " << body.size() << " bytes</p>\n";
+	if (bodySize) {
+		response << "<p><strong>Body Size:</strong> " << bodySize << " bytes</p>\n";
 	}
 
 	response << "<p><strong>Server:</strong> " << config.server_name << "</p>\n";
 	response << "<p><em>CGI functionality is simplified for this demo.</em></p>\n";
 	response << "</body></html>\n";
 
-	sendHtmlResponse(fd, 200, response.str());
+	sendHtmlResponse(client, 200, response.str());
 
 	std::cout << "✅ CGI response sent for " << path << std::endl;
 }
\ No newline at end of file
@@ -0,0 +1,244 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   MultipartParser.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+/*
+The body starts with "--boundary" while every later delimiter is "\r\n--boundary",
+seeding the window with "\r\n" lets one search handle both.
+*/
+MultipartParser::MultipartParser(const std::string& boundary, const std::string& uploadDir, size_t maxFileSize)
+	: _state(PREAMBLE), _delimiter("\r\n--" + boundary), _window("\r\n"), _uploadDir(uploadDir),
+	_maxFileSize(maxFileSize), _fd(-1), _inFilePart(false), _saved(false), _fileSize(0), _errorStatus(0) {}
+
+//an upload that never finished (client gone, bad body) must not leave half a file behind
+MultipartParser::~MultipartParser() {
+	discardTemp();
+}
+
+//closes and unlinks the temporary file, the destination is never touched
+void	MultipartParser::discardTemp() {
+	if (_fd != -1)
+		close(_fd);
+	_fd = -1;
+	if (!_tempPath.empty())
+		unlink(_tempPath.c_str());
+	_tempPath.clear();
+}
+
+/*
+Consumes the next piece of the body. Everything that can't contain (part of) a
+delimiter is handled right away, only the last delimiter-length bytes are kept
+for the next call.
+*/
+void	MultipartParser::feed(const char* data, size_t size) {
+	if (_state == FAILED || _state == EPILOGUE)
+		return;
+	_window.append(data, size);
+
+	size_t	pos = 0;
+	bool	more = true;
+	while (more && _state != FAILED) {
+		more = false;
+		if (_state == PREAMBLE) {
+			size_t found = _window.find(_delimiter, pos);
+			if (found == std::string::npos) {
+				if (_window.size() - pos >= _delimiter.size())
+					pos = _window.size() - _delimiter.size() + 1;
+				break;
+			}
+			pos = found + _delimiter.size();
+			_state = AFTER_BOUNDARY;
+			more = true;
+		}
+		else if (_state == AFTER_BOUNDARY) {
+			if (_window.size() - pos < 2)
+				break;
+			if (_window.compare(pos, 2, "--") == 0) {
+				std::cout << "📦 Closing multipart boundary reached" << std::endl;
+				_state = EPILOGUE;
+				pos = _window.size();
+				break;
+			}
+			if (_window.compare(pos, 2, "\r\n") != 0) {
+				fail(400, "Malformed multipart boundary line");
+				return;
+			}
+			pos += 2;
+			_state = PART_HEADERS;
+			more = true;
+		}
+		else if (_state == PART_HEADERS) {
+			size_t end = (_window.compare(pos, 2, "\r\n") == 0) ? pos : _window.find("\r\n\r\n", pos);
+			if (end == std::string::npos) {
+				if (_window.size() - pos > 8192)
+					fail(400, "Multipart part headers too large");
+				break;
+			}
+			if (!parsePartHeaders(_window.substr(pos, end - pos)))
+				return;
+			pos = (end == pos) ? end + 2 : end + 4;
+			_state = PART_BODY;
+			more = true;
+		}
+		else if (_state == PART_BODY) {
+			size_t found = _window.find(_delimiter, pos);
+			if (found == std::string::npos) {
+				size_t keep = _delimiter.size() - 1;
+				if (_window.size() - pos > keep) {
+					size_t safeEnd = _window.size() - keep;
+					if (!writeFileData(_window.data() + pos, safeEnd - pos))
+						return;
+					pos = safeEnd;
+				}
+				break;
+			}
+			if (!writeFileData(_window.data() + pos, found - pos))
+				return;
+			if (_inFilePart) {
+				closeFile();
+				if (_state == FAILED)
+					return;
+				_saved = true;
+				_inFilePart = false;
+			}
+			pos = found + _delimiter.size();
+			_state = AFTER_BOUNDARY;
+			more = true;
+		}
+	}
+	_window.erase(0, pos);
+}
+
+/*
+Only the first part that carries a filename is saved, like the old
+extractFilenameFromRequest. Other form fields are skipped.
+*/
+bool	MultipartParser::parsePartHeaders(const std::string& headers) {
+	_inFilePart = false;
+	size_t filenamePos = headers.find("filename=\"");
+	if (filenamePos == std::string::npos || _saved || !_filePath.empty())
+		return true;
+
+	size_t filenameStart = filenamePos + 10; // Length of "filename=\""
+	size_t filenameEnd = headers.find("\"", filenameStart);
+	if (filenameEnd == std::string::npos) {
+		fail(400, "Invalid filename format");
+		return false;
+	}
+	std::string filename = headers.substr(filenameStart, filenameEnd - filenameStart);
+	//some browsers send the full client side path, keep only the name
+	size_t slash = filename.find_last_of("/\\");
+	if (slash != std::string::npos)
+		filename = filename.substr(slash + 1);
+	if (filename.empty() || filename == "." || filename == "..") {
+		fail(400, "Empty or invalid filename");
+		return false;
+	}
+
+	createDirectoryIfNotExists(_uploadDir);
+	_filename = filename;
+	_filePath = _uploadDir + "/" + filename;
+	//same directory as the destination, so the final rename() stays on one filesystem
+	std::string temp = _uploadDir + "/.upload-XXXXXX";
+	std::vector<char> name(temp.begin(), temp.end());
+	name.push_back('\0');
+	_fd = mkstemp(&name[0]);
+	if (_fd == -1) {
+		fail(500, "Could not create a temporary file in " + _uploadDir + ": " + strerror(errno));
+		return false;
+	}
+	_tempPath = &name[0];
+	fcntl(_fd, F_SETFD, FD_CLOEXEC);
+	fchmod(_fd, 0644); //mkstemp() makes it 0600, uploads are served back like any other file
+	std::cout << "📁 Streaming upload to: " << _filePath << " (via " << _tempPath << ")" << std::endl;
+	_inFilePart = true;
+	return true;
+}
+
+bool	MultipartParser::writeFileData(const char* data, size_t size) {
+	if (!_inFilePart || !size)
+		return true;
+	_fileSize += size;
+	if (_fileSize > _maxFileSize) {
+		std::cout << "⚠️ File size exceeds limit " << _maxFileSize << std::endl;
+		fail(413, "File too large");
+		return false;
+	}
+	while (size) {
+		ssize_t written = write(_fd, data, size);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written <= 0) {
+			fail(500, std::string("Error writing file data: ") + strerror(errno));
+			return false;
+		}
+		data += written;
+		size -= written;
+	}
+	return true;
+}
+
+void	MultipartParser::closeFile() {
+	int fd = _fd;
+	_fd = -1;
+	if (close(fd) == -1)
+		fail(500, "Error closing upload file");
+}
+
+void	MultipartParser::fail(int status, const std::string& reason) {
+	std::cerr << "❌ Upload failed: " << reason << std::endl;
+	_errorStatus = status;
+	_state = FAILED;
+	discardTemp();
+	_inFilePart = false;
+}
+
+/*
+Called once the whole body went through feed(). Returns true if the closing
+boundary was seen and the file was moved into place, otherwise errorStatus()
+says why not.
+*/
+bool	MultipartParser::finish() {
+	if (_state == FAILED)
+		return false;
+	if (_state != EPILOGUE) {
+		fail(400, "Could not find closing boundary");
+		return false;
+	}
+	if (!_saved) {
+		fail(400, "No filename found in request");
+		return false;
+	}
+	if (rename(_tempPath.c_str(), _filePath.c_str()) == -1) {
+		fail(500, "Could not move the upload to " + _filePath + ": " + strerror(errno));
+		return false;
+	}
+	_tempPath.clear(); //it is the destination now
+	return true;
+}
+
+int	MultipartParser::errorStatus() const {
+	return _errorStatus;
+}
+
+const std::string&	MultipartParser::filename() const {
+	return _filename;
+}
+
+const std::string&	MultipartParser::path() const {
+	return _filePath;
+}
+
+size_t	MultipartParser::fileSize() const {
+	return _fileSize;
+}
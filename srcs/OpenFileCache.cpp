@@ -0,0 +1,173 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   OpenFileCache.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+OpenFileCache g_openFileCache;
+
+FileCachePolicy::FileCachePolicy() : max(0), inactive(60), valid(60), errors(false) {}
+
+FileInfo::FileInfo() : exists(false), isDir(false), size(0), mtime(0), ino(0) {}
+
+OpenFileCache::OpenFileCache() {}
+
+OpenFileCache::~OpenFileCache() {
+	clear();
+}
+
+/*
+stat()s the path and, for regular files when wantFd is set, keeps it open.
+Returns whether the path exists.
+*/
+bool	OpenFileCache::load(const std::string& path, Entry& entry, bool wantFd) {
+	struct stat st;
+	entry.fd = -1;
+	entry.info = FileInfo();
+	int ok;
+	if (wantFd && (entry.fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC)) != -1)
+		ok = fstat(entry.fd, &st);
+	else
+		ok = ::stat(path.c_str(), &st);
+	if (ok == -1) {
+		release(entry);
+		return false;
+	}
+	if (entry.fd != -1 && !S_ISREG(st.st_mode)) {
+		close(entry.fd);
+		entry.fd = -1;
+	}
+	entry.info.exists = true;
+	entry.info.isDir = S_ISDIR(st.st_mode);
+	entry.info.size = st.st_size;
+	entry.info.mtime = st.st_mtime;
+	entry.info.ino = st.st_ino;
+	entry.dev = st.st_dev;
+	return true;
+}
+
+void	OpenFileCache::release(Entry& entry) {
+	if (entry.fd != -1)
+		close(entry.fd);
+	entry.fd = -1;
+}
+
+//true if the file on disk is still the one the entry describes
+bool	OpenFileCache::unchanged(const std::string& path, const Entry& entry) const {
+	struct stat st;
+	if (::stat(path.c_str(), &st) == -1)
+		return !entry.info.exists;
+	return entry.info.exists && st.st_dev == entry.dev && st.st_ino == entry.info.ino
+		&& st.st_size == entry.info.size && st.st_mtime == entry.info.mtime;
+}
+
+void	OpenFileCache::erase(std::map<std::string, Entry>::iterator it) {
+	release(it->second);
+	_lru.erase(it->second.lru);
+	_entries.erase(it);
+}
+
+/*
+Returns the cached entry for path, loading it first if needed. When the policy
+turns the cache off, or the path is missing and errors are not cached, the
+result is loaded into scratch instead and the caller must release() it.
+*/
+OpenFileCache::Entry*	OpenFileCache::lookup(const std::string& path, const FileCachePolicy& policy,
+							Entry& scratch, bool wantFd) {
+	if (!policy.max) {
+		load(path, scratch, wantFd);
+		return &scratch;
+	}
+	time_t now = time(NULL);
+	std::map<std::string, Entry>::iterator it = _entries.find(path);
+	if (it != _entries.end()) {
+		Entry& entry = it->second;
+		if (now - entry.checkedAt < entry.valid || unchanged(path, entry)) {
+			if (now - entry.checkedAt >= entry.valid)
+				entry.checkedAt = now;
+			entry.lastUsed = now;
+			_lru.splice(_lru.begin(), _lru, entry.lru);
+			return &entry;
+		}
+		erase(it);
+	}
+	if (!load(path, scratch, true) && !policy.errors)
+		return &scratch;
+
+	_lru.push_front(path);
+	Entry& entry = _entries[path];
+	entry = scratch;
+	scratch.fd = -1; //now owned by the cache
+	entry.checkedAt = now;
+	entry.lastUsed = now;
+	entry.valid = policy.valid;
+	entry.inactive = policy.inactive;
+	entry.lru = _lru.begin();
+	while (_entries.size() > policy.max)
+		erase(_entries.find(_lru.back()));
+	return &entry;
+}
+
+/*
+Fills info for path, returns whether it exists.
+*/
+bool	OpenFileCache::stat(const std::string& path, const FileCachePolicy& policy, FileInfo& info) {
+	ScopedLock lock(_lock);
+	Entry scratch;
+	Entry* entry = lookup(path, policy, scratch, false);
+	info = entry->info;
+	release(scratch);
+	return info.exists;
+}
+
+/*
+Returns a descriptor for the regular file at path, or -1. The caller owns it
+and must close it, the cache keeps its own copy.
+*/
+int	OpenFileCache::open(const std::string& path, const FileCachePolicy& policy, FileInfo& info) {
+	ScopedLock lock(_lock);
+	Entry scratch;
+	Entry* entry = lookup(path, policy, scratch, true);
+	info = entry->info;
+	if (entry == &scratch) {
+		int fd = scratch.fd;
+		scratch.fd = -1;
+		return fd;
+	}
+	if (entry->fd == -1)
+		return -1;
+	return fcntl(entry->fd, F_DUPFD_CLOEXEC, 0);
+}
+
+//forget a path we just changed ourselves (PUT, DELETE, upload)
+void	OpenFileCache::invalidate(const std::string& path) {
+	ScopedLock lock(_lock);
+	std::map<std::string, Entry>::iterator it = _entries.find(path);
+	if (it != _entries.end())
+		erase(it);
+}
+
+//drops the entries that were not used for their 'inactive' period
+void	OpenFileCache::expire(time_t now) {
+	ScopedLock lock(_lock);
+	std::map<std::string, Entry>::iterator it = _entries.begin();
+	while (it != _entries.end()) {
+		std::map<std::string, Entry>::iterator current = it++;
+		if (now - current->second.lastUsed >= current->second.inactive)
+			erase(current);
+	}
+}
+
+void	OpenFileCache::clear() {
+	ScopedLock lock(_lock);
+	while (!_entries.empty())
+		erase(_entries.begin());
+}
@@ -0,0 +1,121 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RateLimiter.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+RequestLimiter g_requestLimiter;
+
+LimitReqZoneSpec::LimitReqZoneSpec() : size(1024 * 1024), rate(1000) {}
+
+LimitReqPolicy::LimitReqPolicy() : burst(0) {}
+
+/*
+As many buckets as fit in the zone size, rounded down to a power of two so
+the hash is masked instead of divided.
+*/
+RateLimitZone::RateLimitZone(const LimitReqZoneSpec& spec) : _rate(spec.rate) {
+	size_t slots = PROBES;
+	while (slots * 2 * sizeof(Bucket) <= spec.size)
+		slots *= 2;
+	Bucket free = {0, 0, 0};
+	_table.assign(slots, free);
+	_mask = slots - 1;
+}
+
+/*
+Takes one request out of the client's bucket, refilled at the zone's rate up
+to burst + 1 requests since its last visit. Returns false when it is empty.
+*/
+bool	RateLimitZone::allow(in_addr_t ip, int burst, long now) {
+	if (now <= 0)
+		now = 1; //0 marks a free slot
+	long capacity = (burst + 1) * 1000000L;
+	uint32_t hash = static_cast<uint32_t>(ip) * 2654435761u;
+	size_t home = (hash ^ (hash >> 16)) & _mask;
+
+	ScopedLock lock(_lock);
+	Bucket* bucket = NULL;
+	Bucket* oldest = NULL;
+	for (size_t i = 0; i < PROBES && !bucket; ++i) {
+		Bucket& slot = _table[(home + i) & _mask];
+		if (slot.seen && slot.ip == ip)
+			bucket = &slot;
+		else if (!oldest || slot.seen < oldest->seen)
+			oldest = &slot; //a free slot (seen 0) always wins
+	}
+	if (!bucket) {
+		bucket = oldest;
+		bucket->ip = ip;
+		bucket->tokens = capacity;
+		bucket->seen = now;
+	}
+	//ms times thousandths per second is exactly millionths, nothing is lost to rounding.
+	//elapsed is capped so it can't overflow, the bucket is full long before
+	long elapsed = std::min(now - bucket->seen, 86400000L);
+	bucket->tokens = std::min(capacity, bucket->tokens + elapsed * _rate);
+	bucket->seen = now;
+	if (bucket->tokens < 1000000L)
+		return false;
+	bucket->tokens -= 1000000L;
+	return true;
+}
+
+void	RateLimitZone::setRate(long rate) {
+	ScopedLock lock(_lock);
+	_rate = rate;
+}
+
+size_t	RateLimitZone::slots() const {
+	return _table.size();
+}
+
+RequestLimiter::RequestLimiter() {}
+
+RequestLimiter::~RequestLimiter() {
+	for (std::map<std::string, RateLimitZone*>::iterator it = _zones.begin(); it != _zones.end(); ++it)
+		delete it->second;
+}
+
+//a zone that already exists keeps its table and its clients, the size only changes on a restart
+void	RequestLimiter::configure(const std::map<std::string, LimitReqZoneSpec>& zones) {
+	ScopedLock lock(_lock);
+	std::map<std::string, LimitReqZoneSpec>::const_iterator it = zones.begin();
+	for (; it != zones.end(); ++it) {
+		RateLimitZone*& zone = _zones[it->first];
+		if (zone) {
+			zone->setRate(it->second.rate);
+			continue;
+		}
+		zone = new RateLimitZone(it->second);
+		std::cout << "🐢 limit_req_zone " << it->first << ": " << zone->slots() << " clients" << std::endl;
+	}
+}
+
+bool	RequestLimiter::enabled() {
+	ScopedLock lock(_lock);
+	return !_zones.empty();
+}
+
+//true if the request may go on, also when the policy names no zone
+bool	RequestLimiter::allow(const LimitReqPolicy& policy, in_addr_t ip) {
+	if (policy.zone.empty())
+		return true;
+	RateLimitZone* zone;
+	{
+		ScopedLock lock(_lock);
+		std::map<std::string, RateLimitZone*>::iterator it = _zones.find(policy.zone);
+		if (it == _zones.end())
+			return true;
+		zone = it->second;
+	}
+	return zone->allow(ip, policy.burst, monotonicMicros() / 1000);
+}
@@ -0,0 +1,211 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Reactor.cpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+Reactor::Reactor(const std::string& backend) : _backend(backend), _started(false), _connections(0) {
+	_wake[0] = -1;
+	_wake[1] = -1;
+}
+
+Reactor::~Reactor() {
+	stop();
+	for (size_t i = 0; i < _inbox.size(); ++i) {
+		g_admission.release(_inbox[i].fd);
+		close(_inbox[i].fd);
+		_inbox[i].snapshot->release();
+	}
+	if (_wake[0] != -1)
+		close(_wake[0]);
+	if (_wake[1] != -1)
+		close(_wake[1]);
+}
+
+/*
+Creates the wake-up pipe and the thread. The caller blocks SIGINT, SIGTERM and
+SIGHUP around this so only the main thread sees them.
+*/
+bool	Reactor::start() {
+	//close-on-exec like every other server fd, a CGI child must not inherit it
+	if (pipe2(_wake, O_NONBLOCK | O_CLOEXEC) == -1) {
+		std::cerr << "❌ pipe2 failed: " << strerror(errno) << std::endl;
+		return false;
+	}
+	if (pthread_create(&_thread, NULL, &Reactor::run, this) != 0) {
+		std::cerr << "❌ pthread_create failed" << std::endl;
+		return false;
+	}
+	_started = true;
+	return true;
+}
+
+//g_signal is already 0 here, the byte only cuts the reactor's wait short
+void	Reactor::stop() {
+	if (!_started)
+		return;
+	ssize_t ignored = write(_wake[1], "", 1);
+	(void)ignored;
+	pthread_join(_thread, NULL);
+	_started = false;
+}
+
+void*	Reactor::run(void* self) {
+	static_cast<Reactor*>(self)->loop();
+	return NULL;
+}
+
+void	Reactor::loop() {
+	EventBackend* events = EventBackend::create(_backend);
+	ConnectionTable table; //no listeners, the wake-up pipe and the clients handed over
+	table.addWakeup(_wake[0]);
+	if (events->add(_wake[0], EVENT_READ))
+		runEventLoop(*events, table, this); //closes its connections on the way out
+	delete events;
+}
+
+//acceptor side: queue the fd and wake the reactor, which owns it from now on
+void	Reactor::handOff(int fd, const sockaddr_in& peer, ConfigSnapshot* snapshot, const VirtualHosts& hosts) {
+	Handoff handoff;
+	handoff.fd = fd;
+	handoff.peer = peer;
+	handoff.snapshot = snapshot;
+	handoff.hosts = &hosts;
+	{
+		ScopedLock lock(_lock);
+		_inbox.push_back(handoff);
+		++_connections;
+	}
+	ssize_t ignored = write(_wake[1], "", 1); //a full pipe already means "wake up"
+	(void)ignored;
+}
+
+size_t	Reactor::connections() {
+	ScopedLock lock(_lock);
+	return _connections;
+}
+
+int	Reactor::wakeFd() const {
+	return _wake[0];
+}
+
+//reactor side: registers everything the acceptor handed over
+void	Reactor::adopt(EventBackend& events, ConnectionTable& table, TimerWheel& timers) {
+	char drain[256];
+	while (read(_wake[0], drain, sizeof(drain)) > 0)
+		;
+	std::vector<Handoff> inbox;
+	{
+		ScopedLock lock(_lock);
+		inbox.swap(_inbox);
+	}
+	for (size_t i = 0; i < inbox.size(); ++i)
+		registerClient(inbox[i].fd, inbox[i].peer, inbox[i].snapshot, *inbox[i].hosts, events, table, timers);
+}
+
+//the reactor's real count, once per wakeup, for least_conn
+void	Reactor::publish(size_t connections) {
+	ScopedLock lock(_lock);
+	_connections = connections + _inbox.size();
+}
+
+//in turn, or to the reactor holding the fewest connections
+static void	dispatch(int fd, const sockaddr_in& peer, ConfigSnapshot* snapshot, const VirtualHosts& hosts,
+				std::vector<Reactor*>& reactors, size_t turn, bool leastConn) {
+	size_t target = turn % reactors.size();
+	if (leastConn) {
+		size_t fewest = reactors[target]->connections();
+		for (size_t j = 0; j < reactors.size(); ++j) {
+			size_t count = reactors[j]->connections();
+			if (count < fewest) {
+				fewest = count;
+				target = j;
+			}
+		}
+	}
+	reactors[target]->handOff(fd, peer, snapshot, hosts);
+}
+
+/*
+The main thread's loop in threaded mode: it only watches the listeners and
+spreads what it accepts over the reactors, in turn or to the least loaded one.
+It also runs the reloads, the reactors only pick up the new snapshot.
+*/
+static void	runAcceptor(EventBackend& events, ConnectionTable& listeners,
+				std::vector<Reactor*>& reactors, bool leastConn) {
+	std::vector<IoEvent> ready;
+	size_t next = 0;
+	while (g_signal != 0) {
+		if (g_reload) {
+			g_reload = 0;
+			reloadConfig(events, listeners);
+		}
+		if (events.wait(ready, 1000) < 0) {
+			if (errno == EINTR)
+				continue;
+			std::cerr << "❌ " << events.name() << " wait error: " << strerror(errno) << std::endl;
+			break;
+		}
+		for (size_t i = 0; i < ready.size(); ++i) {
+			const FdSlot& slot = listeners[ready[i].fd];
+			if (slot.kind != FD_LISTENER)
+				continue;
+			ServerSocket* listener = slot.listener;
+			for (int accepted = 0; accepted < MAX_ACCEPTS_PER_WAKEUP; ++accepted) {
+				sockaddr_in peer;
+				int fd = listener->acceptClient(peer);
+				if (fd == -1)
+					break;
+				if (!g_admission.admit(fd, peer.sin_addr.s_addr)) {
+					rejectConnection(fd);
+					continue;
+				}
+				dispatch(fd, peer, g_configs.acquire(), listener->getHosts(), reactors, next++, leastConn);
+			}
+		}
+	}
+}
+
+/*
+Starts worker_threads reactors, accepts until shutdown, then stops them. The
+threads are created with SIGINT, SIGTERM and SIGHUP blocked so the signals
+always land on the main thread and cut its wait short. Returns false, without
+having accepted anything, if not a single reactor could start.
+*/
+bool	runReactors(EventBackend& events, ConnectionTable& listeners, const GlobalConfig& global) {
+	sigset_t blocked, previous;
+	sigemptyset(&blocked);
+	sigaddset(&blocked, SIGINT);
+	sigaddset(&blocked, SIGTERM);
+	sigaddset(&blocked, SIGHUP);
+	pthread_sigmask(SIG_BLOCK, &blocked, &previous);
+	std::vector<Reactor*> reactors;
+	for (int i = 0; i < global.worker_threads; ++i) {
+		Reactor* reactor = new Reactor(global.event_backend);
+		if (!reactor->start()) {
+			delete reactor;
+			break;
+		}
+		reactors.push_back(reactor);
+	}
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+	if (reactors.empty()) {
+		std::cerr << "❌ None of the " << global.worker_threads << " reactor threads could start" << std::endl;
+		return false;
+	}
+	std::cout << "🧵 " << reactors.size() << " reactor threads, "
+		<< (global.least_conn ? "least_conn" : "round_robin") << std::endl;
+	runAcceptor(events, listeners, reactors, global.least_conn);
+	for (size_t i = 0; i < reactors.size(); ++i)
+		delete reactors[i]; //stop() joins the thread first
+	return true;
+}
@@ -12,165 +12,168 @@
 
 #include "WebServ.hpp"
 
+StringSlice::StringSlice() : data(""), size(0) {}
+
+StringSlice::StringSlice(const char* data, size_t size) : data(data), size(size) {}
+
+std::string StringSlice::str() const {
+	return std::string(data, size);
+}
+
+bool StringSlice::empty() const {
+	return size == 0;
+}
+
 /*
-* Constructor that parses the raw HTTP request.
+* Constructor that parses the raw HTTP request in place, raw must stay valid
+* for as long as the Request is used.
 */
-Request::Request(const std::string& raw) : _raw(raw) {
-	parse(raw);
+Request::Request(const char* raw, size_t size) : _raw(raw), _size(size), _headersParsed(false) {
+	parse();
 }
 
 /*
 * This function returns the HTTP method (e.g., GET, POST).
 */
 std::string Request::getMethod() const {
-	return _method;
+	return _method.str();
 }
 
 /*
 * This function returns the requested URL path (e.g., /index.html).
 */
 std::string Request::getPath() const {
-	return _path;
+	return _path.str();
 }
 
 /*
- * This function extracts the HTTP request body (after headers).
+ * This function returns a copy of the HTTP request body (after headers).
+ * Prefer getBodyData()/getBodySize() when the bytes are only passed on.
  */
 std::string Request::getBody() const {
-	size_t pos = _raw.find("\r\n\r\n");
-	if (pos == std::string::npos)
-		return "";
-	return _raw.substr(pos + 4);
+	return _body.str();
+}
+
+const char* Request::getBodyData() const {
+	return _body.data;
 }
 
+size_t Request::getBodySize() const {
+	return _body.size;
+}
 
 std::string Request::getQuery() const {
-	return _query;
+	return _query.str();
+}
+
+std::string Request::getVersion() const {
+	return _version.str();
 }
 
 /*
-* This function parses the HTTP request line and extracts method + path.
+* This function splits the request line into method, target and version and
+* finds where the header block and the body start. Only pointers are stored.
 */
-/*void Request::parse(const std::string& raw) {
-	std::istringstream ss(raw);
-	ss >> _method >> _path;
-	if (_path == "/")
-		_path = "/index.html";
-	//extract just the header section
-	size_t headerStart = raw.find("\r\n") + 2;
-	size_t headerEnd = raw.find("\r\n\r\n");
-	if (headerEnd != std::string::npos) {
-		std::string headerBlock = raw.substr(headerStart, headerEnd - headerStart);
-		parseHeaders(headerBlock);
-	}
-}*/
-
-void Request::parse(const std::string& raw) {
-	std::istringstream ss(raw);
-	std::string line;
+void Request::parse() {
+	static const char	terminator[] = "\r\n\r\n";
+	const char*			end = _raw + _size;
 
 	// ✅ Parse the request line
-	if (std::getline(ss, line)) {
-		if (!line.empty() && line[line.size() - 1] == '\r')
-			line.erase(line.size() - 1);
-		std::istringstream lineStream(line);
-		lineStream >> _method >> _target >> _version;
-
-		size_t token = _target.find('?');
-		if (token != std::string::npos) {
-			_path = _target.substr(0, token);
-			_query = _target.substr(token + 1);
-		} else {
-			_path = _target;
-			_query = "";
-		}
+	const char* lineEnd = std::find(_raw, end, '\n');
+	const char* lineStop = lineEnd;
+	if (lineStop > _raw && lineStop[-1] == '\r')
+		--lineStop;
+	StringSlice* parts[3] = { &_method, &_target, &_version };
+	const char* p = _raw;
+	for (int i = 0; i < 3; ++i) {
+		while (p < lineStop && (*p == ' ' || *p == '\t'))
+			++p;
+		const char* tokenStart = p;
+		while (p < lineStop && *p != ' ' && *p != '\t')
+			++p;
+		*parts[i] = StringSlice(tokenStart, p - tokenStart);
 	}
 
-	// ✅ Extract headers
-	std::string headerBlock;
-	std::string headerLine;
-	while (std::getline(ss, headerLine) && headerLine != "\r") {
-		if (!headerLine.empty() && headerLine[headerLine.size() - 1] == '\r')
-			headerLine.erase(headerLine.size() - 1);
-		headerBlock += headerLine + "\n";
+	const char* targetEnd = _target.data + _target.size;
+	const char* token = std::find(_target.data, targetEnd, '?');
+	_path = StringSlice(_target.data, token - _target.data);
+	if (token != targetEnd)
+		_query = StringSlice(token + 1, targetEnd - token - 1);
+
+	// ✅ Locate the headers and the body
+	const char* headerStart = (lineEnd < end) ? lineEnd + 1 : end;
+	const char* blockEnd = std::search(lineStop, end, terminator, terminator + 4);
+	if (blockEnd == end) {
+		_headerBlock = StringSlice(headerStart, end - headerStart);
+		return;
 	}
-	parseHeaders(headerBlock);
+	if (blockEnd + 2 > headerStart)
+		_headerBlock = StringSlice(headerStart, blockEnd + 2 - headerStart);
+	_body = StringSlice(blockEnd + 4, end - blockEnd - 4);
 }
 
+/*
+* Splits one "Key: value" line, the key is lowercased and the value loses its
+* leading whitespace. Returns false for lines without a colon.
+*/
+static bool splitHeaderLine(const char* line, size_t length, std::string& key, std::string& value) {
+	if (length && line[length - 1] == '\r')
+		--length;
+	const char* colon = std::find(line, line + length, ':');
+	if (colon == line + length)
+		return false;
+	key.assign(line, colon - line);
+	for (size_t i = 0; i < key.size(); ++i)
+		key[i] = std::tolower(static_cast<unsigned char>(key[i]));
+	const char* valueStart = colon + 1;
+	while (valueStart < line + length && (*valueStart == ' ' || *valueStart == '\t'))
+		++valueStart;
+	value.assign(valueStart, line + length - valueStart);
+	return true;
+}
 
-/*void Request::parseHeaders(const std::string& headerBlock) {
-	std::istringstream stream(headerBlock);
-	std::string line;
+void Request::parseHeaders() const {
+	const char* p = _headerBlock.data;
+	const char* end = p + _headerBlock.size;
+	std::string key, value;
 
-	// ✅ Parse the first line: method, target, version
-	while (std::getline(stream, line)) {
-		//trim \r from the end
-		if (!line.empty() && line[line.size() - 1] == '\r')
-			line.erase(line.size() - 1);
-		std::istringstream lineStream(line);
-		lineStream >> _method >> _target >> _version;
-	}
-	//parse rest of the headaers
-	while (std::getline(stream, line)) {
-		if (!line.empty() && line[line.size() - 1] == '\r')
-			line.erase(line.size() - 1);
-		size_t colon = line.find(':');
-		if (colon == std::string::npos)
-			continue;
-		std::string key = line.substr(0, colon);
-		std::string value = line.substr(colon + 1);
-
-		//trim leading white space in value
-		size_t start = value.find_first_not_of(" \t");
-		if (start != std::string::npos)
-			value = value.substr(start);
-
-		//normalize key to lowercase
-		for (size_t i = 0; i < key.size(); ++i)
-			key[i] = std::tolower(key[i]);
-		_headers[key] = value;
-	}
-	//extract path and query for CGI
-	size_t token = _target.find('?');
-	if (token != std::string::npos) {
-		_path = _target.substr(0, token);
-		_query = _target.substr(token + 1);
-	}
-	else {
-		_path = _target;
-		_query = "";
+	while (p < end) {
+		const char* lineEnd = std::find(p, end, '\n');
+		if (splitHeaderLine(p, lineEnd - p, key, value))
+			_headers[key] = value;
+		p = (lineEnd < end) ? lineEnd + 1 : end;
 	}
+	_headersParsed = true;
 }
-*/
-
-void Request::parseHeaders(const std::string& headerBlock) {
-	std::istringstream stream(headerBlock);
-	std::string line;
 
-	while (std::getline(stream, line)) {
-		if (!line.empty() && line[line.size() - 1] == '\r')
-			line.erase(line.size() - 1);
-		size_t colon = line.find(':');
-		if (colon == std::string::npos)
-			continue;
-		std::string key = line.substr(0, colon);
-		std::string value = line.substr(colon + 1);
-
-		size_t start = value.find_first_not_of(" \t");
-		if (start != std::string::npos)
-			value = value.substr(start);
-
-		for (size_t i = 0; i < key.size(); ++i)
-			key[i] = std::tolower(static_cast<unsigned char>(key[i]));
-
-		_headers[key] = value;
+/*
+* Looks up a single header by its lowercase name without building the header
+* map, handy when only one or two headers are ever needed.
+*/
+std::string Request::getHeader(const std::string& name) const {
+	if (_headersParsed) {
+		std::map<std::string, std::string>::const_iterator it = _headers.find(name);
+		return (it != _headers.end()) ? it->second : "";
+	}
+	const char* p = _headerBlock.data;
+	const char* end = p + _headerBlock.size;
+	std::string key, value;
+
+	while (p < end) {
+		const char* lineEnd = std::find(p, end, '\n');
+		if (splitHeaderLine(p, lineEnd - p, key, value) && key == name)
+			return value;
+		p = (lineEnd < end) ? lineEnd + 1 : end;
 	}
+	return "";
 }
 
 const std::map<std::string, std::string>& Request::getHeaders() const {
+	if (!_headersParsed)
+		parseHeaders();
 	return _headers;
 }
 
 std::string Request::getRawRequest() const {
-	return _raw;
-}
\ No newline at end of file
+	return std::string(_raw, _size);
+}
@@ -19,17 +19,47 @@ Response::Response() {}
 
 /*
 * This function builds the HTTP header for a given status and content.
+* extraHeaders are complete "Name: value\r\n" lines added before the blank line.
 */
-std::string Response::buildHeader(int statusCode, size_t contentLength, const std::string& contentType) {
+std::string Response::buildHeader(int statusCode, size_t contentLength, const std::string& contentType,
+							bool keepAlive, const std::string& extraHeaders) {
 	std::ostringstream header;
 	header << "HTTP/1.1 " << statusCode << " " << HttpStatus::getStatusMessages(statusCode) << "\r\n";
 	header << "Content-Length: " << contentLength << "\r\n";
-	header << "Content-Type: " << contentType << "; charset=utf-8\r\n";
-	header << "Connection: close\r\n";  // ← Only add this if you want
+	header << "Content-Type: " << contentType;
+	//multipart types carry their boundary parameter instead
+	if (contentType.compare(0, 10, "multipart/") != 0)
+		header << "; charset=utf-8";
+	header << "\r\n";
+	header << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n";
+	header << extraHeaders;
+	header << "\r\n";
+	return header.str();
+}
+
+/*
+ * A 304 has no body, so unlike buildHeader no Content-Length or Content-Type.
+ */
+std::string Response::buildNotModified(bool keepAlive, const std::string& extraHeaders) {
+	std::ostringstream header;
+	header << "HTTP/1.1 304 " << HttpStatus::getStatusMessages(304) << "\r\n";
+	header << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n";
+	header << extraHeaders;
 	header << "\r\n";
 	return header.str();
 }
 
+/*
+ * Formats t as an HTTP date, e.g. "Sun, 06 Nov 1994 08:49:37 GMT".
+ */
+std::string Response::httpDate(time_t t) {
+	char buffer[64];
+	struct tm tm;
+	gmtime_r(&t, &tm);
+	strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+	return buffer;
+}
+
 /*
  * This function returns the appropriate Content-Type for a given file path.
  */
@@ -55,9 +85,10 @@ std::string Response::getContentType(const std::string& path) {
 	return "application/octet-stream";
 }
 
-std::string Response::build(int statusCode, const std::string& body, const std::string& contentType) {
+std::string Response::build(int statusCode, const std::string& body, const std::string& contentType,
+							bool keepAlive) {
 	std::ostringstream oss;
-	oss << buildHeader(statusCode, body.size(), contentType);
+	oss << buildHeader(statusCode, body.size(), contentType, keepAlive);
 	oss << body;
 	return oss.str();
 }
\ No newline at end of file
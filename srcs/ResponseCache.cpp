@@ -0,0 +1,127 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ResponseCache.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+ResponseCache g_responseCache;
+ResponseCache g_gzipCache;
+
+ResponseCache::Key::Key(const std::string& path, bool keepAlive, const std::string& variant)
+	: path(path), keepAlive(keepAlive), variant(variant) {}
+
+bool	ResponseCache::Key::operator<(const Key& other) const {
+	if (path != other.path)
+		return path < other.path;
+	if (keepAlive != other.keepAlive)
+		return keepAlive < other.keepAlive;
+	return variant < other.variant;
+}
+
+ResponseCache::ResponseCache() : _budget(0), _maxFile(0), _used(0), _hits(0), _misses(0) {}
+
+ResponseCache::~ResponseCache() {
+	clear();
+}
+
+void	ResponseCache::configure(size_t budget, size_t maxFile) {
+	ScopedLock lock(_lock);
+	reset();
+	_budget = budget;
+	_maxFile = maxFile;
+}
+
+//only small regular files are worth keeping in memory
+bool	ResponseCache::accepts(const FileInfo& info) const {
+	ScopedLock lock(_lock);
+	return _budget && info.exists && !info.isDir && static_cast<size_t>(info.size) <= _maxFile;
+}
+
+void	ResponseCache::erase(std::map<Key, Entry>::iterator it) {
+	_used -= it->second.response.size();
+	_lru.erase(it->second.lru);
+	_entries.erase(it);
+}
+
+/*
+Copies the cached response for path into response, returns false if there is
+none. An entry whose file changed on disk since it was stored is dropped and
+counts as a miss.
+*/
+bool	ResponseCache::find(const std::string& path, bool keepAlive, const std::string& variant,
+			const FileInfo& info, std::string& response) {
+	ScopedLock lock(_lock);
+	std::map<Key, Entry>::iterator it = _entries.find(Key(path, keepAlive, variant));
+	if (it != _entries.end() && (it->second.size != info.size
+		|| it->second.mtime != info.mtime || it->second.ino != info.ino)) {
+		erase(it);
+		it = _entries.end();
+	}
+	if (it == _entries.end()) {
+		++_misses;
+		return false;
+	}
+	++_hits;
+	_lru.splice(_lru.begin(), _lru, it->second.lru);
+	response = it->second.response;
+	return true;
+}
+
+void	ResponseCache::store(const std::string& path, bool keepAlive, const std::string& variant,
+			const FileInfo& info, const std::string& response) {
+	ScopedLock lock(_lock);
+	if (response.size() > _budget)
+		return;
+	Key key(path, keepAlive, variant);
+	std::map<Key, Entry>::iterator old = _entries.find(key);
+	if (old != _entries.end())
+		erase(old);
+	while (_used + response.size() > _budget)
+		erase(_entries.find(_lru.back()));
+
+	_lru.push_front(key);
+	Entry& entry = _entries[key];
+	entry.response = response;
+	entry.size = info.size;
+	entry.mtime = info.mtime;
+	entry.ino = info.ino;
+	entry.lru = _lru.begin();
+	_used += response.size();
+}
+
+//drops every variant of a path we just changed ourselves, they sort next to each other
+void	ResponseCache::invalidate(const std::string& path) {
+	ScopedLock lock(_lock);
+	std::map<Key, Entry>::iterator it = _entries.lower_bound(Key(path, false, ""));
+	while (it != _entries.end() && it->first.path == path)
+		erase(it++);
+}
+
+void	ResponseCache::clear() {
+	ScopedLock lock(_lock);
+	reset();
+}
+
+void	ResponseCache::reset() {
+	_entries.clear();
+	_lru.clear();
+	_used = 0;
+}
+
+unsigned long	ResponseCache::hits() const {
+	ScopedLock lock(_lock);
+	return _hits;
+}
+
+unsigned long	ResponseCache::misses() const {
+	ScopedLock lock(_lock);
+	return _misses;
+}
@@ -0,0 +1,253 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   RewriteEngine.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+//the probe cache evicts its oldest entries rather than grow past this
+static const size_t	MAX_PROBES = 10000;
+
+RewriteEngine::RewriteEngine() : _probeTtl(5) {}
+
+//regex_t can't be copied, the copy compiles its own from the patterns
+RewriteEngine::RewriteEngine(const RewriteEngine& other)
+	: _literal(other._literal), _rules(other._rules), _tryFiles(other._tryFiles), _probeTtl(other._probeTtl) {
+	compileRules();
+}
+
+RewriteEngine& RewriteEngine::operator=(const RewriteEngine& other) {
+	if (this != &other) {
+		freeRules();
+		_literal = other._literal;
+		_rules = other._rules;
+		_tryFiles = other._tryFiles;
+		_probeTtl = other._probeTtl;
+		_probes.clear();
+		_probeOrder.clear();
+		compileRules();
+	}
+	return *this;
+}
+
+RewriteEngine::~RewriteEngine() {
+	freeRules();
+}
+
+//true for '^/some/path$' without any other regex syntax
+static bool	isLiteralPattern(const std::string& pattern) {
+	if (pattern.size() < 3 || pattern[0] != '^' || pattern[pattern.size() - 1] != '$')
+		return false;
+	return pattern.find_first_of(".[]()*+?{}|\\^$", 1) == pattern.size() - 1;
+}
+
+void	RewriteEngine::addRule(const std::string& pattern, const std::string& replacement) {
+	if (isLiteralPattern(pattern)) {
+		std::string path = pattern.substr(1, pattern.size() - 2);
+		if (!_literal.count(path)) //the first rule for a path wins, as it would in order
+			_literal[path] = replacement;
+		return;
+	}
+	Rule rule;
+	rule.pattern = pattern;
+	rule.replacement = replacement;
+	rule.compiled = NULL;
+	_rules.push_back(rule);
+}
+
+void	RewriteEngine::setTryFiles(const std::vector<std::string>& entries) {
+	_tryFiles = entries;
+}
+
+void	RewriteEngine::setProbeTtl(int seconds) {
+	_probeTtl = seconds;
+}
+
+/*
+Called once the server block is parsed. Without a try_files directive we keep
+the old clean-URL behaviour: the file itself, then .html, then a directory index.
+*/
+void	RewriteEngine::compile() {
+	if (_tryFiles.empty()) {
+		_tryFiles.push_back("$uri");
+		_tryFiles.push_back("$uri.html");
+		_tryFiles.push_back("$uri/index.html");
+		_tryFiles.push_back("$uri");
+	}
+	freeRules();
+	compileRules();
+}
+
+void	RewriteEngine::compileRules() {
+	for (size_t i = 0; i < _rules.size(); ++i) {
+		_rules[i].compiled = new regex_t;
+		if (regcomp(_rules[i].compiled, _rules[i].pattern.c_str(), REG_EXTENDED) != 0) {
+			std::string pattern = _rules[i].pattern;
+			delete _rules[i].compiled;
+			_rules.resize(i);
+			throw std::runtime_error("Invalid rewrite regex: " + pattern);
+		}
+	}
+}
+
+void	RewriteEngine::freeRules() {
+	for (size_t i = 0; i < _rules.size(); ++i) {
+		if (_rules[i].compiled) {
+			regfree(_rules[i].compiled);
+			delete _rules[i].compiled;
+			_rules[i].compiled = NULL;
+		}
+	}
+}
+
+/*
+Returns the uri rewritten by the first matching rule, or the uri itself.
+*/
+std::string	RewriteEngine::rewrite(const std::string& uri) const {
+	std::map<std::string, std::string>::const_iterator literal = _literal.find(uri);
+	if (literal != _literal.end())
+		return literal->second;
+
+	regmatch_t groups[10];
+	for (size_t i = 0; i < _rules.size(); ++i) {
+		if (regexec(_rules[i].compiled, uri.c_str(), 10, groups, 0) != 0)
+			continue;
+		const std::string& replacement = _rules[i].replacement;
+		std::string result;
+		for (size_t j = 0; j < replacement.size(); ++j) {
+			if (replacement[j] == '$' && j + 1 < replacement.size()
+				&& replacement[j + 1] >= '0' && replacement[j + 1] <= '9') {
+				const regmatch_t& group = groups[replacement[++j] - '0'];
+				if (group.rm_so != -1)
+					result.append(uri, group.rm_so, group.rm_eo - group.rm_so);
+			}
+			else
+				result += replacement[j];
+		}
+		return result;
+	}
+	return uri;
+}
+
+static std::string	expandUri(const std::string& entry, const std::string& uri) {
+	std::string result;
+	size_t pos = 0;
+	size_t var;
+	while ((var = entry.find("$uri", pos)) != std::string::npos) {
+		result.append(entry, pos, var - pos);
+		result += uri;
+		pos = var + 4;
+	}
+	result.append(entry, pos, std::string::npos);
+	return result;
+}
+
+/*
+Resolves uri through try_files: the first entry that exists under root, else
+the last entry. A last entry like '=404' sets status instead.
+*/
+std::string	RewriteEngine::tryFiles(const std::string& uri, const std::string& root,
+				const FileCachePolicy& cache, int& status) const {
+	time_t now = time(NULL);
+	if (_probeTtl > 0) {
+		ScopedLock lock(_probeLock);
+		std::map<std::string, Probe>::const_iterator it = _probes.find(uri);
+		if (it != _probes.end() && now < it->second.expires) {
+			status = it->second.status;
+			return it->second.uri;
+		}
+	}
+
+	Probe probe;
+	probe.status = 0;
+	size_t last = _tryFiles.size() - 1;
+	size_t i = 0;
+	for (; i < last; ++i) {
+		FileInfo info;
+		std::string candidate = expandUri(_tryFiles[i], uri);
+		//like nginx, only entries ending in '/' may resolve to a directory
+		bool wantDir = candidate[candidate.size() - 1] == '/';
+		if (g_openFileCache.stat(root + candidate, cache, info) && info.isDir == wantDir) {
+			probe.uri = candidate;
+			break;
+		}
+	}
+	if (i == last) {
+		//nothing on disk: the fallback, this is the miss we want to remember
+		if (_tryFiles[last][0] == '=')
+			probe.status = std::atoi(_tryFiles[last].c_str() + 1);
+		else
+			probe.uri = expandUri(_tryFiles[last], uri);
+		if (probe.uri.empty())
+			probe.uri = uri;
+	}
+	if (_probeTtl > 0) {
+		ScopedLock lock(_probeLock);
+		evictProbes(now);
+		probe.expires = now + _probeTtl;
+		_probes[uri] = probe;
+		_probeOrder.push_back(std::make_pair(uri, probe.expires));
+	}
+	status = probe.status;
+	return probe.uri;
+}
+
+/*
+Pops the oldest probes while they have expired or the cache is full, a few
+at a time as new ones come in instead of all at once. An entry of the queue
+whose probe was since invalidated or replaced no longer matches and is just
+dropped. Called with _probeLock held.
+*/
+void	RewriteEngine::evictProbes(time_t now) const {
+	while (!_probeOrder.empty()
+		&& (_probeOrder.front().second <= now || _probes.size() >= MAX_PROBES)) {
+		std::map<std::string, Probe>::iterator it = _probes.find(_probeOrder.front().first);
+		if (it != _probes.end() && it->second.expires == _probeOrder.front().second)
+			_probes.erase(it);
+		_probeOrder.pop_front();
+	}
+}
+
+/*
+The file at path (a file system path) was created, replaced or deleted:
+drops the probes whose try_files entries could have looked at it. For an
+entry like '$uri.html' that is the one URI the file name gives back; when
+the file is not under root, or an entry can't be inverted, every probe goes.
+*/
+void	RewriteEngine::invalidate(const std::string& path, const std::string& root) const {
+	if (_probeTtl <= 0)
+		return;
+	ScopedLock lock(_probeLock);
+	if (_probes.empty())
+		return;
+	bool underRoot = !root.empty() && path.compare(0, root.size(), root) == 0 && path.size() > root.size()
+		&& (path[root.size()] == '/' || root[root.size() - 1] == '/');
+	if (!underRoot) {
+		_probes.clear();
+		return;
+	}
+	std::string file = path.substr(root.size());
+	if (file[0] != '/')
+		file = "/" + file;
+	for (size_t i = 0; i + 1 < _tryFiles.size(); ++i) {
+		const std::string& entry = _tryFiles[i];
+		size_t var = entry.find("$uri");
+		if (var == std::string::npos || entry.find("$uri", var + 4) != std::string::npos) {
+			_probes.clear();
+			return;
+		}
+		std::string prefix = entry.substr(0, var);
+		std::string suffix = entry.substr(var + 4);
+		if (file.size() < prefix.size() + suffix.size() || file.compare(0, prefix.size(), prefix) != 0
+			|| file.compare(file.size() - suffix.size(), suffix.size(), suffix) != 0)
+			continue;
+		_probes.erase(file.substr(prefix.size(), file.size() - prefix.size() - suffix.size()));
+	}
+}
@@ -12,7 +12,16 @@
 
 #include "WebServ.hpp"
 
-ServerConfig::ServerConfig() : ports(0), client_max_body_size(0) {}
+ListenOptions::ListenOptions() : backlog(511), deferred(false), fastopen(0), reuseport(false) {}
+
+bool	ListenOptions::operator==(const ListenOptions& other) const {
+	return backlog == other.backlog && deferred == other.deferred && fastopen == other.fastopen
+		&& reuseport == other.reuseport;
+}
+
+ServerConfig::ServerConfig() : ports(0), client_max_body_size(0), client_max_header_size(0), keepalive_timeout(-1),
+	keepalive_requests(0),
+	client_header_timeout(0), client_body_timeout(0), send_timeout(0) {}
 
 void	ServerConfig::print() const {
 	std::cout << "\n======================" << std::endl;
@@ -25,6 +34,13 @@ void	ServerConfig::print() const {
 	std::cout << "root: " << root << std::endl;
 	std::cout << "index: " << index << std::endl;
 	std::cout << "client_max_body_size: " << client_max_body_size << std::endl;
+	std::cout << "client_max_header_size: " << client_max_header_size << std::endl;
+	std::cout << "keepalive_timeout: " << keepalive_timeout << "s" << std::endl;
+	std::cout << "keepalive_requests: " << keepalive_requests << std::endl;
+	std::cout << "timeouts: header " << client_header_timeout << "s, body " << client_body_timeout
+		<< "s, send " << send_timeout << "s" << std::endl;
+	std::cout << "open_file_cache: max=" << open_file_cache.max << " inactive=" << open_file_cache.inactive
+		<< "s valid=" << open_file_cache.valid << "s errors=" << open_file_cache.errors << std::endl;
 
 	for (std::map<int, std::string>::const_iterator it = error_pages.begin(); it != error_pages.end(); ++it)
 		std::cout << "error_page " << it->first << " => " << it->second << std::endl;
@@ -50,8 +66,18 @@ void	applyDefaults(ServerConfig& server) {
 		server.root = "www";
 	if (server.index.empty())
 		server.index = "index.html";
-	if (server.server_name.empty())
-		server.server_name = "default_server";
 	if (!server.client_max_body_size)
 		server.client_max_body_size = 1000000;
+	if (!server.client_max_header_size)
+		server.client_max_header_size = 16384;
+	if (server.keepalive_timeout < 0)
+		server.keepalive_timeout = 15;
+	if (!server.keepalive_requests)
+		server.keepalive_requests = 100;
+	if (server.client_header_timeout <= 0)
+		server.client_header_timeout = 60;
+	if (server.client_body_timeout <= 0)
+		server.client_body_timeout = 60;
+	if (server.send_timeout <= 0)
+		server.send_timeout = 60;
 }
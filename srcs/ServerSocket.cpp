@@ -12,7 +12,7 @@
 
 #include "WebServ.hpp"
 
-ServerSocket::ServerSocket() : _fd(-1) {}
+ServerSocket::ServerSocket() : _fd(-1), _hosts(NULL) {}
 
 ServerSocket::~ServerSocket() {
 	closeSocket();
@@ -41,8 +41,10 @@ bool checkHost(const std::string& host, in_addr& addr) {
 htons converts host byte order to network byte order (for port).
 fcntl sets the socket to non-blocking mode.
 We bind, listen, and accept incoming connections on this socket.
+options come from the parameters of the listen line (backlog=, deferred, ...).
 */
-bool	ServerSocket::init(int port, const std::string& host) {
+bool	ServerSocket::init(int port, const std::string& host, const ListenOptions& options) {
+	_address = host + ":" + intToStr(port);
 	//creates a TCP socket for IPv4 and stores the FD
 	_fd = safe_socket(AF_INET, SOCK_STREAM, 0);
 	if (_fd == -1) return false;
@@ -54,6 +56,19 @@ bool	ServerSocket::init(int port, const std::string& host) {
 		close(_fd);
 		return false;
 	}
+	//with worker processes each one binds its own socket and the kernel spreads connections
+	if (options.reuseport && setsockopt(_fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) == -1) {
+		std::cerr << "setsockopt SO_REUSEPORT failed: " << strerror(errno) << std::endl;
+		closeSocket();
+		return false;
+	}
+	//both are only hints, a kernel without them still serves
+	int deferSeconds = 1;
+	if (options.deferred && setsockopt(_fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, &deferSeconds, sizeof(deferSeconds)) == -1)
+		std::cerr << "⚠️ setsockopt TCP_DEFER_ACCEPT failed: " << strerror(errno) << std::endl;
+	if (options.fastopen > 0
+		&& setsockopt(_fd, IPPROTO_TCP, TCP_FASTOPEN, &options.fastopen, sizeof(options.fastopen)) == -1)
+		std::cerr << "⚠️ setsockopt TCP_FASTOPEN failed: " << strerror(errno) << std::endl;
 	//make the socket non-blocking
 	if (fcntl(_fd, F_SETFL, O_NONBLOCK) == -1) {
 		std::cerr << "Failed to set FD to non-blocking: " << std::strerror(errno) << std::endl;
@@ -75,30 +90,42 @@ bool	ServerSocket::init(int port, const std::string& host) {
 		closeSocket();
 		return false;
 	}
-	if (!safe_listen(_fd, 20)) {
+	if (!safe_listen(_fd, options.backlog)) {
 		closeSocket();
 		return false;
 	}
 	return true;
 }
 
-void  ServerSocket::setConfig(const ServerConfig& config) {
-	_config = config;
+//set when the socket opens and again on every reload, lives in the current ConfigSnapshot
+void  ServerSocket::setHosts(const VirtualHosts& hosts) {
+	_hosts = &hosts;
+}
+
+const VirtualHosts& ServerSocket::getHosts() const {
+	return *_hosts;
 }
 
-const ServerConfig& ServerSocket::getConfig() const {
-	return _config;
+const std::string& ServerSocket::address() const {
+	return _address;
 }
 
-int		ServerSocket::acceptClient() {
-	int	client_fd = accept(_fd, NULL, NULL);
+/*
+accept4() hands the fd back already non-blocking and close-on-exec (CGI
+children must not inherit client sockets), no fcntl() round trip.
+peer gets the client's address, admission control counts connections by it.
+Returns -1 once the queue is empty (EAGAIN) or on a real error.
+*/
+int		ServerSocket::acceptClient(sockaddr_in& peer) {
+	int	client_fd;
+	socklen_t length;
+	do {
+		length = sizeof(peer);
+		client_fd = accept4(_fd, reinterpret_cast<sockaddr*>(&peer), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+	} while (client_fd == -1 && errno == EINTR);
 	if (client_fd == -1) {
-		std::cerr << "Failed to accept: " << std::strerror(errno) << std::endl;
-		return -1;
-	}
-	if (fcntl(client_fd, F_SETFL, O_NONBLOCK) == -1) {
-		std::cerr << "Failed to set FD to non-blocking: " << std::strerror(errno) << std::endl;
-		close(client_fd);
+		if (errno != EAGAIN && errno != EWOULDBLOCK)
+			std::cerr << "Failed to accept: " << std::strerror(errno) << std::endl;
 		return -1;
 	}
 	std::cout << "Accepted connection on socket: " << client_fd << std::endl;
@@ -0,0 +1,120 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+TimerHandle::TimerHandle(int fd) : fd(fd), expires(0), level(-1), slot(0), prev(NULL), next(NULL) {}
+
+bool	TimerHandle::armed() const {
+	return level != -1;
+}
+
+TimerWheel::TimerWheel(time_t now) : _now(now), _count(0) {
+	for (int level = 0; level < LEVELS; ++level)
+		for (int slot = 0; slot < SLOTS; ++slot)
+			_slots[level][slot] = NULL;
+}
+
+//schedule() never lets a timer fire later than now + this
+static const time_t	MAX_DELAY = (static_cast<time_t>(1) << (6 * 3)) - 1;
+
+/*
+Puts the timer in the finest level whose span still covers its expiry.
+A slot index may wrap onto the slot being served, it is then reached
+again exactly when its window comes round.
+*/
+void	TimerWheel::place(TimerHandle& timer) {
+	time_t delta = timer.expires - _now;
+	int level = 0;
+	while (level < LEVELS - 1 && delta >= static_cast<time_t>(1) << (SLOT_BITS * (level + 1)))
+		++level;
+	timer.level = level;
+	timer.slot = (timer.expires >> (SLOT_BITS * level)) & (SLOTS - 1);
+	TimerHandle*& head = _slots[level][timer.slot];
+	timer.prev = NULL;
+	timer.next = head;
+	if (head)
+		head->prev = &timer;
+	head = &timer;
+}
+
+//takes an armed timer out of its slot and disarms it
+void	TimerWheel::unlink(TimerHandle& timer) {
+	if (timer.prev)
+		timer.prev->next = timer.next;
+	else
+		_slots[timer.level][timer.slot] = timer.next;
+	if (timer.next)
+		timer.next->prev = timer.prev;
+	timer.prev = NULL;
+	timer.next = NULL;
+	timer.level = -1;
+}
+
+//(re)arms the timer, an expiry that is already due fires on the next tick
+void	TimerWheel::schedule(TimerHandle& timer, time_t expires) {
+	cancel(timer);
+	if (expires <= _now)
+		expires = _now + 1;
+	if (expires - _now > MAX_DELAY)
+		expires = _now + MAX_DELAY;
+	timer.expires = expires;
+	place(timer);
+	++_count;
+}
+
+void	TimerWheel::cancel(TimerHandle& timer) {
+	if (!timer.armed())
+		return;
+	unlink(timer);
+	--_count;
+}
+
+//moves the slot of level whose window starts now one level down
+void	TimerWheel::cascade(int level) {
+	TimerHandle*& head = _slots[level][(_now >> (SLOT_BITS * level)) & (SLOTS - 1)];
+	TimerHandle* timer = head;
+	head = NULL;
+	while (timer) {
+		TimerHandle* next = timer->next;
+		place(*timer);
+		timer = next;
+	}
+}
+
+/*
+Runs the wheel up to now and appends the fd of every timer that fired.
+Fired timers are disarmed, the owner decides what happens next.
+*/
+void	TimerWheel::advance(time_t now, std::vector<int>& expired) {
+	//after a clock jump there is no point in replaying more than one full turn
+	if (now - _now > MAX_DELAY)
+		_now = now - MAX_DELAY;
+	while (_now < now) {
+		++_now;
+		for (int level = LEVELS - 1; level > 0; --level) {
+			if ((_now & ((static_cast<time_t>(1) << (SLOT_BITS * level)) - 1)) == 0)
+				cascade(level);
+		}
+		TimerHandle*& slot = _slots[0][_now & (SLOTS - 1)];
+		while (slot) {
+			TimerHandle* timer = slot;
+			unlink(*timer);
+			--_count;
+			expired.push_back(timer->fd);
+		}
+	}
+}
+
+size_t	TimerWheel::size() const {
+	return _count;
+}
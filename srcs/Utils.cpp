@@ -12,140 +12,6 @@
 
 #include "WebServ.hpp"
 
-/**
- * Extract filename from multipart form data
- */
-bool extractFilenameFromRequest(const std::string& request, std::string& filename) {
-	size_t filenamePos = request.find("filename=\"");
-	if (filenamePos == std::string::npos) {
-		std::cerr << "❌ No filename found in request" << std::endl;
-		return false;
-	}
-
-	size_t filenameStart = filenamePos + 10; // Length of "filename=\""
-	size_t filenameEnd = request.find("\"", filenameStart);
-	if (filenameEnd == std::string::npos) {
-		std::cerr << "❌ Invalid filename format" << std::endl;
-		return false;
-	}
-
-	filename = request.substr(filenameStart, filenameEnd - filenameStart);
-	if (filename.empty()) {
-		std::cerr << "❌ Empty filename" << std::endl;
-		return false;
-	}
-
-	return true;
-}
-
-/**
- * Find the start and end positions of file content in the request
- */
-bool findFileContentBoundaries(const std::string& request, const std::string& filename,
-							size_t& contentStart, size_t& contentEnd) {
-
-	// Find Content-Type header after filename
-	size_t filenamePos = request.find("filename=\"" + filename + "\"");
-	size_t contentTypePos = request.find("Content-Type:", filenamePos);
-	if (contentTypePos == std::string::npos) {
-		std::cerr << "❌ No Content-Type header found" << std::endl;
-		return false;
-	}
-
-	// Find start of file content (after double CRLF)
-	size_t contentStartMarker = request.find("\r\n\r\n", contentTypePos);
-	if (contentStartMarker == std::string::npos) {
-		std::cerr << "❌ Could not find content start marker" << std::endl;
-		return false;
-	}
-	contentStart = contentStartMarker + 4;
-
-	// Extract boundary to find content end
-	std::string rawBoundary = extractBoundary(request);
-	if (rawBoundary.empty()) {
-		std::cerr << "❌ Empty boundary string" << std::endl;
-		return false;
-	}
-	std::string boundary = "--" + rawBoundary;
-
-	// Find end of file content
-	contentEnd = request.find(boundary, contentStart);
-	if (contentEnd == std::string::npos) {
-		std::cerr << "❌ Could not find closing boundary" << std::endl;
-		return false;
-	}
-
-	// Adjust for CRLF before boundary
-	if (contentEnd >= 2 &&
-		request[contentEnd - 1] == '\n' &&
-		request[contentEnd - 2] == '\r') {
-		contentEnd -= 2;
-	}
-
-	// Validate boundaries
-	if (contentEnd <= contentStart) {
-		std::cerr << "❌ Invalid content boundaries (end <= start)" << std::endl;
-		return false;
-	}
-
-	return true;
-}
-
-/**
- * Check if file size is within server limits
- */
-bool validateUploadFileSize(size_t fileSize, const ServerConfig& config) {
-	size_t maxSize = config.client_max_body_size;
-	if (maxSize == 0) {
-		// Choose one of these defaults:
-
-		// Option 1: 50MB default (good for photos and documents)
-		//maxSize = 50 * 1024 * 1024; // 50MB
-
-		// Option 2: 100MB default (good for videos and large files)
-		maxSize = 100 * 1024 * 1024; // 100MB
-	}
-
-	if (fileSize > maxSize) {
-		std::cout << "⚠️ File size " << fileSize << " exceeds limit " << maxSize << std::endl;
-		std::cout << "📊 File size: " << (fileSize / 1024 / 1024) << "MB, Limit: " << (maxSize / 1024 / 1024) << "MB" << std::endl;
-		return false;
-	}
-
-	return true;
-}
-
-/**
- * Write file data to server filesystem
- */
-bool writeFileToServer(const std::string& request, size_t contentStart, size_t contentLength,
-					const std::string& filePath) {
-
-	// Create upload directory if needed
-	std::string uploadDir = filePath.substr(0, filePath.find_last_of('/'));
-	createDirectoryIfNotExists(uploadDir);
-
-	// Open file for binary writing
-	std::ofstream outFile(filePath.c_str(), std::ios::binary);
-	if (!outFile.is_open()) {
-		std::cerr << "❌ Could not open destination file: " << filePath << std::endl;
-		return false;
-	}
-
-	// Get pointer to file data and write it
-	const char* fileData = request.c_str() + contentStart;
-	outFile.write(fileData, contentLength);
-	outFile.close();
-
-	// Check for write errors
-	if (outFile.fail()) {
-		std::cerr << "❌ Error writing file data" << std::endl;
-		return false;
-	}
-
-	return true;
-}
-
 /**
  * Load success template and process it with filename
  */
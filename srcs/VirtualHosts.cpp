@@ -0,0 +1,127 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   VirtualHosts.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+VirtualHosts::VirtualHosts() : _default(0) {}
+
+//FNV-1a, names are short and this spreads them well enough
+static size_t	hashName(const std::string& name) {
+	size_t hash = 2166136261u;
+	for (size_t i = 0; i < name.size(); ++i) {
+		hash ^= static_cast<unsigned char>(name[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static std::string	toLower(const std::string& value) {
+	std::string result(value);
+	for (size_t i = 0; i < result.size(); ++i)
+		result[i] = std::tolower(static_cast<unsigned char>(result[i]));
+	return result;
+}
+
+void	VirtualHosts::add(const ServerConfig& server, bool isDefault) {
+	//checkDuplicateHostPortPairs() already refused a second default_server
+	if (isDefault)
+		_default = _servers.size();
+	_servers.push_back(server);
+}
+
+void	VirtualHosts::setAddress(const std::string& address) {
+	_address = address;
+}
+
+const std::string&	VirtualHosts::address() const {
+	return _address;
+}
+
+/*
+Hashes every server_name of every block, called once all blocks are added.
+*/
+void	VirtualHosts::build() {
+	size_t names = 0;
+	for (size_t i = 0; i < _servers.size(); ++i)
+		names += line_splitter(_servers[i].server_name).size();
+	size_t buckets = 16;
+	while (buckets < names * 2)
+		buckets *= 2;
+	_buckets.assign(buckets, std::vector<Name>());
+
+	for (size_t i = 0; i < _servers.size(); ++i) {
+		std::vector<std::string> list = line_splitter(toLower(_servers[i].server_name));
+		for (size_t j = 0; j < list.size(); ++j) {
+			if (list[j][0] == '.') {
+				insert(list[j].substr(1), i);
+				insert("*" + list[j], i);
+			}
+			else
+				insert(list[j], i);
+		}
+	}
+}
+
+void	VirtualHosts::insert(const std::string& name, size_t server) {
+	const Name* existing = find(name);
+	if (existing) {
+		if (existing->server != server)
+			std::cerr << "⚠️ Conflicting server_name '" << name << "', ignored" << std::endl;
+		return;
+	}
+	Name entry;
+	entry.name = name;
+	entry.server = server;
+	_buckets[hashName(name) & (_buckets.size() - 1)].push_back(entry);
+}
+
+const VirtualHosts::Name*	VirtualHosts::find(const std::string& name) const {
+	const std::vector<Name>& bucket = _buckets[hashName(name) & (_buckets.size() - 1)];
+	for (size_t i = 0; i < bucket.size(); ++i) {
+		if (bucket[i].name == name)
+			return &bucket[i];
+	}
+	return NULL;
+}
+
+/*
+Picks the server block for a Host header value ('Example.com:8081',
+'[::1]:8081', '' for HTTP/1.0 clients that send none).
+*/
+const ServerConfig&	VirtualHosts::select(const std::string& header) const {
+	std::string host = toLower(header);
+	if (!host.empty() && host[0] == '[')
+		host = host.substr(0, host.find(']') + 1);
+	else if (host.find(':') != std::string::npos)
+		host.erase(host.find(':'));
+	if (!host.empty() && host[host.size() - 1] == '.')
+		host.erase(host.size() - 1);
+	if (host.empty() || _servers.size() == 1)
+		return _servers[_default];
+
+	const Name* match = find(host);
+	//'*.example.com' for 'a.b.example.com': the longest suffix first
+	for (size_t dot = host.find('.'); !match && dot != std::string::npos; dot = host.find('.', dot + 1))
+		match = find("*" + host.substr(dot));
+	//'www.example.*' for 'www.example.com': the longest prefix first
+	for (size_t dot = host.rfind('.'); !match && dot != std::string::npos && dot > 0; dot = host.rfind('.', dot - 1))
+		match = find(host.substr(0, dot + 1) + "*");
+	return match ? _servers[match->server] : _servers[_default];
+}
+
+const ServerConfig&	VirtualHosts::defaultServer() const {
+	return _servers[_default];
+}
+
+size_t	VirtualHosts::size() const {
+	return _servers.size();
+}
@@ -12,7 +12,8 @@
 
 #include "../include/WebServ.hpp"
 
-int g_signal = -1;
+volatile sig_atomic_t g_signal = -1; //read by every reactor thread, written by the handler
+volatile sig_atomic_t g_reload = 0;
 
 // Signal handler for SIGINT and SIGTERM; sets global flag to initiate server shutdown.
 void handleSignal(int signal) {
@@ -24,17 +25,33 @@ void handleSignal(int signal) {
 		}
 		g_signal = 0;
 	}
+	else if (signal == SIGTERM) //also how the master stops its workers
+		g_signal = 0;
+	else if (signal == SIGHUP) //the loop reloads the config once its wait is cut short
+		g_reload = 1;
 }
 
 /*
-Initializes the server using the config file, sets up server sockets and poll monitoring,
-and runs the main poll loop to handle client connections and requests.
+The process-wide settings of the global section, at startup and on every reload.
+*/
+void	applyGlobalConfig(const GlobalConfig& global) {
+	g_responseCache.configure(global.static_cache_size, global.static_cache_max_file);
+	g_gzipCache.configure(global.gzip_cache_size, global.static_cache_max_file);
+	g_admission.configure(global);
+	g_requestLimiter.configure(global.limit_req_zones);
+}
+
+/*
+Initializes the server using the config file, then either serves from this
+process or, with worker_processes > 1, hands over to the master (Workers.cpp).
 */
 int	init_webserv(std::string configPath) {
 	ConfigParser	parser;
 
 	try {
 		parser.parseFile(configPath);
+		//check for Duplicate Host Port Pairs
+		checkDuplicateHostPortPairs(parser.getServers());
 	}
 	catch (const std::exception& e) {
 		std::cerr << "❌ Error while parsing config: " << e.what() << std::endl;
@@ -47,21 +64,43 @@ int	init_webserv(std::string configPath) {
 		std::cerr << "❌ Error: No servers found in config file.\n";
 		return 1;
 	}
-	//check for Duplicate Host Port Pairs
-	checkDuplicateHostPortPairs(servers);
-	
-	std::vector<ServerSocket*> serverSockets;
-	std::vector<struct pollfd> fds;
-	std::map<int, ServerSocket*> fdToSocket;
-	if (!initialiseSockets(servers, serverSockets, fds, fdToSocket))
+
+	applyGlobalConfig(parser.getGlobal());
+	g_configs.setSource(configPath); //read again on SIGHUP
+
+	if (parser.getGlobal().worker_processes > 1)
+		return runMaster(parser, parser.getGlobal().worker_processes);
+	return serveWebserv(parser, false);
+}
+
+/*
+Sets up server sockets and the event backend, and runs the main event loop to
+handle client connections and requests. This is the whole life of a worker.
+*/
+int	serveWebserv(const ConfigParser& parser, bool reusePort) {
+	EventBackend* events = EventBackend::create(parser.getGlobal().event_backend);
+	std::cout << "⚙️ Event backend: " << events->name() << std::endl;
+
+	ConnectionTable table; //the listeners, and the clients when this thread serves them
+	ConfigSnapshot* config = new ConfigSnapshot(parser, 1);
+	g_configs.setReusePort(reusePort);
+	g_configs.publish(config); //the store now holds our reference
+	if (!initialiseSockets(*config, *events, table, reusePort)) {
+		g_configs.clear();
+		delete events;
 		return 1;
+	}
 
-	std::map<int, ClientConnection*> clients;
-	std::map<int, ServerSocket*> clientToServer;
-	
-	runEventLoop(fds, fdToSocket, clients, clientToServer);
+	//no reactor thread could start: this thread serves everything itself
+	if (parser.getGlobal().worker_threads <= 1 || !runReactors(*events, table, parser.getGlobal())) {
+		if (parser.getGlobal().worker_threads > 1)
+			std::cerr << "⚠️ Falling back to the single event loop" << std::endl;
+		runEventLoop(*events, table, NULL);
+	}
 
-	shutDownWebserv(serverSockets, clients);
+	shutDownWebserv(table);
+	g_configs.clear(); //after the connections, the last one frees the snapshot
+	delete events;
 	std::cout << "👋 Bye bye!\n";
 	return 0;
 }
@@ -74,6 +113,7 @@ int main(int ac, char **av) {
 
 	signal(SIGINT, handleSignal); //handle Contrl + C
 	signal(SIGTERM, handleSignal); //handle kill <pid>
+	signal(SIGHUP, handleSignal); //kill -HUP <pid> reloads the config file
 	std::string configPath;
 	std::cout << "		My Webserv in C++98" << std::endl;
 	std::cout << "--------------------------------------------------\n " << std::endl;
@@ -0,0 +1,101 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   Workers.cpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "WebServ.hpp"
+
+/*
+Forks one worker. The child runs its own event loop on its own SO_REUSEPORT
+listeners, so the kernel spreads new connections across the workers, and
+never returns here.
+*/
+static pid_t	spawnWorker(const ConfigParser& parser) {
+	std::cout.flush(); //or the child would print the master's buffered output again
+	pid_t pid = fork();
+	if (pid == -1) {
+		std::cerr << "❌ fork failed: " << strerror(errno) << std::endl;
+		return -1;
+	}
+	if (pid == 0) {
+		std::cout << "👷 Worker " << getpid() << " started" << std::endl;
+		std::exit(serveWebserv(parser, true));
+	}
+	return pid;
+}
+
+/*
+SIGHUP to the master: every worker reloads on its own (see reloadConfig), the
+master re-reads the file too so that a replacement worker starts on the new
+configuration. A file that does not parse leaves everything as it was.
+*/
+static void	reloadWorkers(ConfigParser& current, const std::set<pid_t>& children) {
+	ConfigParser	parser;
+	if (!reparseConfig(parser))
+		return;
+	current = parser;
+	for (std::set<pid_t>::const_iterator it = children.begin(); it != children.end(); ++it)
+		kill(*it, SIGHUP);
+	std::cout << "🔁 Master " << getpid() << " reloaded " << children.size() << " workers" << std::endl;
+}
+
+/*
+worker_processes N: the config is parsed once, here, and the workers inherit it.
+The master serves nothing itself, it only supervises: a worker killed by a
+signal (a crash) is replaced, one that exits on its own (e.g. it could not
+bind) is not. Ctrl+C reaches every process of the group, a SIGTERM or a
+SIGHUP to the master is passed on to the workers.
+*/
+int	runMaster(const ConfigParser& config, int workers) {
+	ConfigParser parser(config); //what replacement workers start with, re-read on SIGHUP
+	std::set<pid_t> children;
+	for (int i = 0; i < workers; ++i) {
+		pid_t pid = spawnWorker(parser);
+		if (pid > 0)
+			children.insert(pid);
+	}
+	std::cout << "🧑‍🏭 Master " << getpid() << " supervising " << children.size() << " workers" << std::endl;
+
+	while (g_signal != 0 && !children.empty()) {
+		if (g_reload) {
+			g_reload = 0;
+			reloadWorkers(parser, children);
+		}
+		int status;
+		pid_t pid;
+		while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+			children.erase(pid);
+			if (!WIFSIGNALED(status)) {
+				std::cerr << "⚠️ Worker " << pid << " exited with status " << WEXITSTATUS(status) << std::endl;
+				continue;
+			}
+			std::cerr << "💥 Worker " << pid << " killed by signal " << WTERMSIG(status) << std::endl;
+			if (g_signal == 0)
+				continue;
+			pid_t replacement = spawnWorker(parser);
+			if (replacement > 0)
+				children.insert(replacement);
+		}
+		sleep(1); //cut short by SIGINT/SIGTERM/SIGHUP, a crashed worker is replaced within a second
+	}
+
+	for (std::set<pid_t>::iterator it = children.begin(); it != children.end(); ++it)
+		kill(*it, SIGTERM);
+	while (!children.empty()) {
+		int status;
+		pid_t pid = waitpid(-1, &status, 0);
+		if (pid > 0)
+			children.erase(pid);
+		else if (errno != EINTR)
+			break;
+	}
+	std::cout << "👋 Master " << getpid() << " bye bye!\n";
+	return 0;
+}
@@ -91,41 +91,267 @@ std::string	cleanValue(std::string s) {
 	return trim(s);
 }
 
-void	shutDownWebserv(std::vector<ServerSocket*>& serverSockets, std::map<int, ClientConnection*>& clients) {
+void	shutDownWebserv(ConnectionTable& table) {
+	std::vector<ServerSocket*> serverSockets;
+	table.listeners(serverSockets);
 	for (size_t i = 0; i < serverSockets.size(); i++)
 		serverSockets[i]->closeSocket();
-	for (std::map<int, ClientConnection*>::iterator it = clients.begin(); it != clients.end(); ++it)
-		delete it->second;
+	table.destroyClients();
 	for (size_t i = 0; i < serverSockets.size(); ++i)
 		delete serverSockets[i];
+	g_openFileCache.clear();
+	std::cout << "📊 Static response cache: " << g_responseCache.hits() << " hits, "
+		<< g_responseCache.misses() << " misses\n";
+	std::cout << "📊 Gzip cache: " << g_gzipCache.hits() << " hits, " << g_gzipCache.misses() << " misses\n";
+	g_responseCache.clear();
+	g_gzipCache.clear();
 	std::cout << "🧼 Webserv shut down cleanly.\n";
 }
 
-void serveStaticFile(std::string path, int client_fd, const ServerConfig &config) {
+//reads size bytes from the start of fd, pread() leaves the shared offset of cached fds alone
+static bool	readWholeFile(int fd, size_t size, std::string& out) {
+	size_t start = out.size();
+	out.resize(start + size);
+	size_t done = 0;
+	while (done < size) {
+		ssize_t n = pread(fd, &out[start + done], size - done, done);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		done += n;
+	}
+	return true;
+}
+
+/*
+Strong validator of a static file: changes whenever the file is replaced
+(inode), rewritten (mtime) or resized.
+*/
+std::string	fileETag(const FileInfo& info) {
+	std::ostringstream oss;
+	oss << std::hex << "\"" << info.ino << "-" << info.size << "-" << info.mtime << "\"";
+	return oss.str();
+}
+
+//ETag and Last-Modified lines for the headers of a static response
+std::string	validatorHeaders(const FileInfo& info) {
+	return "ETag: " + fileETag(info) + "\r\nLast-Modified: " + Response::httpDate(info.mtime) + "\r\n";
+}
+
+/*
+If-None-Match wins over If-Modified-Since (RFC 9110 13.2.2). Tags are compared
+weakly, as the RFC asks for GET and HEAD.
+*/
+bool	isNotModified(const Request& req, const FileInfo& info) {
+	std::string ifNoneMatch = req.getHeader("if-none-match");
+	if (!ifNoneMatch.empty()) {
+		std::string etag = fileETag(info);
+		std::istringstream tags(ifNoneMatch);
+		std::string tag;
+		while (std::getline(tags, tag, ',')) {
+			trim(tag);
+			if (tag.compare(0, 2, "W/") == 0)
+				tag.erase(0, 2);
+			if (tag == "*" || tag == etag)
+				return true;
+		}
+		return false;
+	}
+	std::string ifModifiedSince = req.getHeader("if-modified-since");
+	trim(ifModifiedSince);
+	struct tm tm;
+	std::memset(&tm, 0, sizeof(tm));
+	if (ifModifiedSince.empty() || !strptime(ifModifiedSince.c_str(), "%a, %d %b %Y %H:%M:%S GMT", &tm))
+		return false;
+	return info.mtime <= timegm(&tm);
+}
+
+void	sendNotModified(ClientConnection& client, const FileInfo& info) {
+	client.queueOutput(Response::buildNotModified(client.keepAlive(), validatorHeaders(info)));
+}
+
+/*
+If-Range carries the validator the client's partial copy was made from, the
+range is only honoured while it still matches exactly: a strong ETag or the
+Last-Modified date.
+*/
+static bool	ifRangeMatches(const Request& req, const FileInfo& info) {
+	std::string ifRange = req.getHeader("if-range");
+	trim(ifRange);
+	return ifRange.empty() || ifRange == fileETag(info) || ifRange == Response::httpDate(info.mtime);
+}
+
+/*
+True if an Accept-Encoding header allows coding, i.e. lists it (or '*')
+without q=0. Codings are case-insensitive.
+*/
+bool	acceptsEncoding(const std::string& acceptEncoding, const std::string& coding) {
+	std::istringstream items(acceptEncoding);
+	std::string item;
+	while (std::getline(items, item, ',')) {
+		std::string name = item.substr(0, item.find(';'));
+		trim(name);
+		for (size_t i = 0; i < name.size(); ++i)
+			name[i] = std::tolower(static_cast<unsigned char>(name[i]));
+		if (name != coding && name != "*")
+			continue;
+		size_t q = item.find("q=");
+		if (q == std::string::npos || std::strtod(item.c_str() + q + 2, NULL) > 0)
+			return true;
+	}
+	return false;
+}
+
+/*
+gzip_static/brotli_static: when the build already produced path.br or path.gz
+and the client accepts that coding, we send the sibling instead and spend no
+CPU compressing. Brotli wins, it is smaller. Returns the coding, or "" and
+leaves filePath alone.
+*/
+static std::string	findPrecompressed(const Request& req, const std::string& fullPath,
+						const LocationConfig& location, std::string& filePath) {
+	std::string acceptEncoding = req.getHeader("accept-encoding");
+	if (acceptEncoding.empty())
+		return "";
+	static const char*	codings[] = { "br", "gzip" };
+	static const char*	suffixes[] = { ".br", ".gz" };
+	bool				enabled[] = { location.brotli_static, location.gzip_static };
+	for (int i = 0; i < 2; ++i) {
+		if (!enabled[i] || !acceptsEncoding(acceptEncoding, codings[i]))
+			continue;
+		FileInfo info;
+		std::string candidate = fullPath + suffixes[i];
+		if (g_openFileCache.stat(candidate, location.open_file_cache, info) && !info.isDir) {
+			filePath = candidate;
+			return codings[i];
+		}
+	}
+	return "";
+}
+
+/*
+Gzips a static file once per version and level: the complete compressed
+response of a file up to static_cache_max_file is kept in g_gzipCache, which
+checks it against the file's inode, size and mtime like the plain response cache. The tag is weak, the bytes differ from the file's.
+Returns false if the file could not be read, the caller then sends it plain.
+*/
+static bool	serveGzipped(ClientConnection& client, const std::string& filePath, const FileInfo& info,
+				const std::string& contentType, const LocationConfig& location) {
+	//locations may compress the same file at different levels
+	std::string level = intToStr(location.gzip.level);
+	std::string cached;
+	if (g_gzipCache.find(filePath, client.keepAlive(), level, info, cached)) {
+		client.queueOutput(cached);
+		return true;
+	}
+	FileInfo opened;
+	int fileFd = g_openFileCache.open(filePath, location.open_file_cache, opened);
+	if (fileFd == -1)
+		return false;
+	std::string body;
+	bool ok = readWholeFile(fileFd, opened.size, body);
+	close(fileFd);
+	std::string compressed;
+	if (!ok || !gzipCompress(body.data(), body.size(), location.gzip.level, compressed))
+		return false;
+	std::string extra = "ETag: W/" + fileETag(opened) + "\r\nLast-Modified: " + Response::httpDate(opened.mtime)
+		+ "\r\nVary: Accept-Encoding\r\nContent-Encoding: gzip\r\n";
+	std::string response = Response::buildHeader(200, compressed.size(), contentType, client.keepAlive(), extra)
+		+ compressed;
+	if (g_gzipCache.accepts(opened)) //same per-file limit as the plain cache
+		g_gzipCache.store(filePath, client.keepAlive(), level, opened, response);
+	client.queueOutput(response);
+	return true;
+}
+
+/*
+A client that already holds the current version gets a 304 before the file is
+even opened. Small files are answered from the response cache with a single send(), their
+first miss reads them once and stores the whole response there. Compressible
+types are gzipped once and served from the gzip cache after that.
+Other files are not read into memory: we queue the headers and the open file,
+the connection then streams it with sendfile() as the socket drains, and so
+are the pieces of a Range request.
+The descriptor and size come from the open file cache when the location has one.
+*/
+void serveStaticFile(std::string path, ClientConnection& client, const Request& req,
+	const LocationConfig& location, const ServerConfig &config) {
 	// Check if the path is empty or just a slash, then use the index file
 	std::cout << "🗂️ Serving static file: fullPath = '" << path << "'" << std::endl;
 
 	if (path.empty() || path == "/")
 		path = "/" + config.index;
 	std::string fullPath = config.root + path;
-	std::ifstream file(fullPath.c_str());
-	if (!file.is_open()) {
-		std::cerr << "❌ Static file not found: " << fullPath << std::endl;
+	std::string contentType = Response::getContentType(fullPath);
+	// filePath is what we send: fullPath or its precompressed sibling
+	std::string filePath = fullPath;
+	std::string encoding;
+	if (location.gzip_static || location.brotli_static)
+		encoding = findPrecompressed(req, fullPath, location, filePath);
+	std::string encodingHeaders;
+	if (location.gzip_static || location.brotli_static
+		|| (location.gzip.enabled && location.gzip.matchesType(contentType)))
+		encodingHeaders = "Vary: Accept-Encoding\r\n";
+	if (!encoding.empty())
+		encodingHeaders += "Content-Encoding: " + encoding + "\r\n";
+
+	FileInfo info;
+	std::string range = req.getHeader("range");
+	if (g_openFileCache.stat(filePath, location.open_file_cache, info) && !info.isDir) {
+		if (isNotModified(req, info)) {
+			sendNotModified(client, info);
+			return;
+		}
+		// client.gzip() is only set when the client accepts gzip, ranges are served plain
+		if (encoding.empty() && range.empty() && client.gzip()
+			&& client.gzip()->applies(contentType, info.size) && static_cast<size_t>(info.size) <= location.gzip.maxLength
+			&& serveGzipped(client, filePath, info, contentType, location))
+			return;
+		std::string cached;
+		//encodingHeaders depend on the location, they are part of the key
+		if (range.empty() && g_responseCache.accepts(info)
+			&& g_responseCache.find(filePath, client.keepAlive(), encodingHeaders, info, cached)) {
+			client.queueOutput(cached);
+			return;
+		}
+	}
+	int fileFd = g_openFileCache.open(filePath, location.open_file_cache, info);
+	if (fileFd == -1) {
+		std::cerr << "❌ Static file not found: " << filePath << std::endl;
 		std::string errorBody = getErrorPageBody(404, config);
-		sendHtmlResponse(client_fd, 404, errorBody);
+		sendHtmlResponse(client, 404, errorBody);
 		return;
 	}
 
-	std::string body((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
-	file.close();
-	// sendHtmlResponse(client_fd, 200, body);
-	Response resp;
-	std::string contentType = resp.getContentType(fullPath);
-	std::string response = Response::build(200, body, contentType);
-	ssize_t sent = send(client_fd, response.c_str(), response.size(), 0);
-	if (sent != (ssize_t)response.size()) {
-			std::cerr << "❌ Failed to send response for status code: " << sent << " of " << response.size() << " bytes\n";
+	std::string validators = validatorHeaders(info) + encodingHeaders;
+	if (!range.empty() && ifRangeMatches(req, info)) {
+		std::vector<ByteRange> ranges;
+		RangeResult result = parseRangeHeader(range, info.size, ranges);
+		if (result == RANGE_NOT_SATISFIABLE) {
+			close(fileFd);
+			std::ostringstream extra;
+			extra << "Content-Range: bytes */" << info.size << "\r\n";
+			client.queueOutput(Response::buildHeader(416, 0, "text/html", client.keepAlive(), extra.str()));
+			return;
+		}
+		//out of descriptors for a multipart answer: the whole file with a 200 still works
+		if (result == RANGE_SATISFIABLE && queueByteRanges(client, fileFd, info.size, contentType, ranges, validators))
+			return;
 	}
+	std::string header = Response::buildHeader(200, info.size, contentType, client.keepAlive(),
+		"Accept-Ranges: bytes\r\n" + validators);
+	if (g_responseCache.accepts(info)) {
+		std::string response = header;
+		if (readWholeFile(fileFd, info.size, response)) {
+			close(fileFd);
+			g_responseCache.store(filePath, client.keepAlive(), encodingHeaders, info, response);
+			client.queueOutput(response);
+			return;
+		}
+	}
+	client.queueOutput(header);
+	client.queueFile(fileFd, 0, info.size);
 }
 
 std::string extractBoundary(const std::string& request) {
@@ -163,13 +389,18 @@ std::string extractBoundary(const std::string& request) {
 * designed specifically to handle binary file uploads correctly.
 */
 //
-void sendHtmlResponse(int fd, int code, const std::string& body) {
-
-	std::string response = Response::build(code, body, "text/html");
-	ssize_t sent = send(fd, response.c_str(), response.size(), 0);
-	if (sent != (ssize_t)response.size()) {
-		std::cerr << "❌ Failed to send response for status code: " << sent << " of " << response.size() << " bytes\n";
+void sendHtmlResponse(ClientConnection& client, int code, const std::string& body) {
+	//generated pages (listings, templates, CGI output) are gzipped when the location asks for it
+	const GzipPolicy* gzip = client.gzip();
+	std::string compressed;
+	if (gzip && gzip->applies("text/html", body.size())
+		&& gzipCompress(body.data(), body.size(), gzip->level, compressed)) {
+		client.queueOutput(Response::buildHeader(code, compressed.size(), "text/html", client.keepAlive(),
+			"Content-Encoding: gzip\r\nVary: Accept-Encoding\r\n") + compressed);
+		return;
 	}
+	//only queued here, the event loop writes it out as the socket drains
+	client.queueOutput(Response::build(code, body, "text/html", client.keepAlive()));
 }
 
 /*
@@ -209,36 +440,24 @@ location /images  # more specific
 location /images/cats  # even more specific (and longest match)
 
 We do not use exact match as an exact match would miss: location /images/cats/cute.jpg
+Prefixes match whole path segments ('/images' does not match '/imagesfoo'), and
+'=' exact and '~' regex locations take precedence as in nginx. The locations are
+compiled into a trie when the config is parsed, see LocationRouter.
+Returns NULL when no location matches.
  */
-LocationConfig matchLocation(const std::string& path, const ServerConfig& config) {
-	const std::vector<LocationConfig>& locations = config.locations;
-
-	LocationConfig bestMatch;
-	size_t length = 0;
-
-	for (size_t i = 0; i < locations.size(); ++i) {
-		const std::string& locationPath = locations[i].path;
-		if (path.find(locationPath) == 0 && locationPath.length() > length) {
-			bestMatch = locations[i];
-			length = locationPath.length();
-		}
-	}
-	return bestMatch;
+const LocationConfig* matchLocation(const std::string& path, const ServerConfig& config) {
+	return config.routes.match(path, config.locations);
 }
 
-void handleClientCleanup(int fd, std::vector<pollfd>& fds,
-		std::map<int, ClientConnection*>& clients, size_t& i) {
-	// Remove from clients map
-	std::map<int, ClientConnection*>::iterator it = clients.find(fd);
-	if (it != clients.end()) {
-		delete it->second;
-		clients.erase(it);
-	}
-
-	// Close socket
-	close(fd);
+void handleClientCleanup(int fd, EventBackend& events, ConnectionTable& table) {
+	// Stop watching the fd before it is closed and possibly reused
+	events.remove(fd);
 
-	// Remove from poll fds
-	fds.erase(fds.begin() + i);
-	--i;
+	// Give the slot back to the table, the destructor closes the socket
+	if (table.client(fd))
+		table.destroyClient(fd);
+	else {
+		g_admission.release(fd);
+		close(fd);
+	}
 }
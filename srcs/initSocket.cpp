@@ -17,215 +17,487 @@ This function takes the groups of Servers, Sockets etc
 and tries to initilise them
 */
 
-bool initialiseSockets(const std::vector<ServerConfig>& servers, std::vector<ServerSocket*>& serverSockets,
-			std::vector<struct pollfd>& fds, std::map<int, ServerSocket*>& fdToSocket) {
-	// Creates a ServerSocket, binds/listens on specified host/port, then configures the server.
-	// Adds the server FD to the poll list to monitor for POLLIN events,
-	// and tracks the ServerSocket for later access and cleanup.
-	for (size_t i = 0; i < servers.size(); ++i) {
-		for (size_t j = 0; j < servers[i].ports.size(); ++j) {
-			ServerSocket*	server = new ServerSocket();
-			if (!server->init(servers[i].ports[j], servers[i].host)) {
-				delete server;
-				std::cerr << "❌ Failed to initialise server on port: " << servers[i].ports[j] << std::endl;
-				continue;
-			}
-			server->setConfig(servers[i]);
-			int	fd = server->getFD();
-			struct pollfd pfd;
-			pfd.fd = fd;
-			pfd.events = POLLIN;
-			pfd.revents = 0;
-			fds.push_back(pfd);
-			serverSockets.push_back(server);
-			fdToSocket[fd] = server;
-			std::cout << "✅ Server is up at http://" << servers[i].host << ":" << servers[i].ports[j] << std::endl;
-		}
-	}
-	if (serverSockets.empty())
+/*
+Creates a ServerSocket, binds/listens on the host:port, registers its fd with
+the event backend for read events (listeners stay level-triggered: one accept
+per wakeup must not lose the rest) and with the table, which owns it from now on.
+*/
+static bool	openListener(const std::string& address, const ListenAddress& listen, EventBackend& events,
+				ConnectionTable& table, bool reusePort) {
+	ListenOptions options = listen.options;
+	options.reuseport |= reusePort;
+	ServerSocket*	server = new ServerSocket();
+	if (!server->init(listen.port, listen.host, options)) {
+		delete server;
+		std::cerr << "❌ Failed to initialise server on port: " << listen.port << std::endl;
 		return false;
+	}
+	int	fd = server->getFD();
+	if (!events.add(fd, EVENT_READ)) {
+		delete server;
+		return false;
+	}
+	server->setHosts(listen.hosts);
+	table.addListener(fd, server);
+	std::cout << "✅ Server is up at http://" << address << std::endl;
+	if (listen.hosts.size() > 1)
+		std::cout << "🏠 " << listen.hosts.size() << " virtual hosts on socket " << fd << std::endl;
 	return true;
 }
 
 /*
-this is the main I/O loop with poll()
+One listening socket per host:port of the configuration, blocks listening on
+the same address share it and are told apart by Host.
+*/
+bool initialiseSockets(const ConfigSnapshot& config, EventBackend& events, ConnectionTable& table, bool reusePort) {
+	bool any = false;
+	const std::map<std::string, ListenAddress>& addresses = config.addresses();
+	std::map<std::string, ListenAddress>::const_iterator it = addresses.begin();
+	for (; it != addresses.end(); ++it)
+		any |= openListener(it->first, it->second, events, table, reusePort);
+	return any;
+}
+
+/*
+Parses the config file again for a reload, false (and the reason logged) if
+it is not one we could start with.
+*/
+bool	reparseConfig(ConfigParser& parser) {
+	try {
+		parser.parseFile(g_configs.path());
+		checkDuplicateHostPortPairs(parser.getServers());
+		bool listens = false;
+		for (size_t i = 0; i < parser.getServers().size(); ++i)
+			listens |= !parser.getServers()[i].ports.empty();
+		if (!listens)
+			throw std::runtime_error("nothing to listen on");
+	}
+	catch (const std::exception& e) {
+		std::cerr << "❌ Reload failed, keeping the current configuration: " << e.what() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/*
+SIGHUP: parses the config file again and, if it is valid, makes it the one
+new requests are served from. Runs on the thread that owns the listeners.
+A socket whose address is still configured stays open and keeps its accept
+queue (its listen options are those it was opened with), a new address gets
+a socket, a removed one is closed. Connections already open finish their
+current request on the old configuration and switch on their next one (see
+ClientConnection::followReload). A broken file changes nothing.
+*/
+void	reloadConfig(EventBackend& events, ConnectionTable& table) {
+	std::cout << "🔁 Reloading " << g_configs.path() << std::endl;
+	ConfigParser	parser;
+	if (!reparseConfig(parser))
+		return;
+	ConfigSnapshot* previous = g_configs.acquire();
+	ConfigSnapshot* snapshot = new ConfigSnapshot(parser, previous->generation() + 1);
+	const GlobalConfig& before = previous->global();
+	const GlobalConfig& after = snapshot->global();
+	if (before.event_backend != after.event_backend || before.worker_processes != after.worker_processes
+		|| before.worker_threads != after.worker_threads || before.least_conn != after.least_conn
+		|| before.shed_target != after.shed_target || before.shed_interval != after.shed_interval)
+		std::cerr << "⚠️ use, worker_processes, worker_threads, least_conn and shed_* only change on a restart"
+			<< std::endl;
+	previous->release();
+
+	std::set<std::string> open;
+	std::vector<ServerSocket*> listeners;
+	table.listeners(listeners);
+	for (size_t i = 0; i < listeners.size(); ++i) {
+		const VirtualHosts* hosts = snapshot->hosts(listeners[i]->address());
+		if (hosts) {
+			listeners[i]->setHosts(*hosts);
+			open.insert(listeners[i]->address());
+			continue;
+		}
+		std::cout << "🔌 No longer listening on " << listeners[i]->address() << std::endl;
+		events.remove(listeners[i]->getFD());
+		table.remove(listeners[i]->getFD());
+		delete listeners[i];
+	}
+	const std::map<std::string, ListenAddress>& addresses = snapshot->addresses();
+	std::map<std::string, ListenAddress>::const_iterator it = addresses.begin();
+	for (; it != addresses.end(); ++it)
+		if (!open.count(it->first))
+			openListener(it->first, it->second, events, table, g_configs.reusePort());
+
+	applyGlobalConfig(after);
+	g_configs.publish(snapshot);
+	std::cout << "✅ Configuration generation " << snapshot->generation() << " is live" << std::endl;
+}
+
+/*
+this is the main I/O loop, the backend (epoll or poll) only hands us the fds
+that are ready so each wakeup costs O(ready) instead of O(connections), and
+the table tells what each one is with a single index (see ConnectionTable).
+With worker_threads each reactor runs it without listeners, new connections
+arrive through reactor's wake-up pipe instead (see Reactor).
 */
-void	runEventLoop(	std::vector<struct pollfd>& fds,
-						std::map<int, ServerSocket*>& fdToSocket,
-						std::map<int, ClientConnection*>& clients,
-						std::map<int, ServerSocket*>& clientToServer) {
+void	runEventLoop(EventBackend& events, ConnectionTable& table, Reactor* reactor) {
 
+	std::vector<IoEvent> ready;
+	time_t lastSweep = monotonicSeconds();
+	TimerWheel timers(lastSweep); //this loop's connections only, no locking, on the monotonic clock
+	LoadShedder shedder(g_admission.shedTarget(), g_admission.shedInterval());
 	while (g_signal != 0) {
-		//safe to call poll()
-		// revents will be automatically set by poll(), no need to reset manually
-		int ready = poll(&fds[0], fds.size(), -1);
-		if (ready < 0) {
+		//between two waits, no ready event can point at a listener the reload closed
+		if (g_reload && !reactor) { //only the thread holding the listeners reloads
+			g_reload = 0;
+			reloadConfig(events, table);
+		}
+		//wake up at least once a second to expire timed out connections and cached files
+		int n = events.wait(ready, 1000);
+		if (n < 0) {
 			if (errno == EINTR)
 				continue;
-			std::cerr << "❌ Poll() error: " << strerror(errno) << std::endl;
+			std::cerr << "❌ " << events.name() << " wait error: " << strerror(errno) << std::endl;
 			break;
 		}
-		//handle ready FD's (if there is data to read)
-		for (size_t i = 0; i < fds.size(); ++i) {
-			//revents field is declared as a short
-			short tempRevent = fds[i].revents;
-			int fd = fds[i].fd;
+		long started = monotonicMicros();
+		time_t now = started / 1000000;
+		for (size_t i = 0; i < ready.size(); ++i) {
+			int fd = ready[i].fd;
+			int flags = ready[i].flags;
 
-			if (tempRevent & (POLLERR | POLLHUP | POLLNVAL)) {
-				std::cerr << "❌ Error or hangup on client side\n" << fd << std::endl;
-				close(fd);
-				fds.erase(fds.begin() + i);
-				--i;
+			const FdSlot& slot = table[fd];
+			if (slot.kind == FD_LISTENER) {
+				handleNewClient(slot.listener, events, table, timers);
+				continue;
+			}
+			if (slot.kind == FD_WAKEUP && reactor) {
+				reactor->adopt(events, table, timers);
+				continue;
+			}
+			if (slot.kind != FD_CLIENT) {
+				std::cerr << "⚠️ Event on unknown fd " << fd << std::endl;
+				handleClientCleanup(fd, events, table);
 				continue;
 			}
-			if (tempRevent & POLLIN) {
-				if (fdToSocket.count(fd))
-					handleNewClient(fdToSocket[fd], fds, clients, clientToServer);
-				else if (clients.count(fd))
-					handleExistingClient(fd, fds, clients, i, clientToServer[fd]->getConfig());
-				else {
-					std::cerr << "⚠️ POLLIN on unknown fd " << fd << std::endl;
-					close(fd);
-					fds.erase(fds.begin() + i);
-					--i;
-				}
+			if (flags & EVENT_ERROR) {
+				std::cerr << "❌ Error or hangup on client side\n" << fd << std::endl;
+				handleClientCleanup(fd, events, table);
+				continue;
 			}
+			if (flags & EVENT_WRITE)
+				handleClientWrite(fd, events, table, shedder);
+			else if (flags & EVENT_READ)
+				handleExistingClient(fd, events, table, shedder);
+			//the handlers may have closed it, otherwise it now waits on something new
+			if (ClientConnection* client = table.client(fd))
+				client->updateTimer(now);
+		}
+		if (reactor)
+			reactor->publish(table.clientCount());
+		if (now != lastSweep) {
+			closeTimedOutConnections(events, table, timers, now);
+			g_openFileCache.expire(time(NULL)); //its entries are stamped with wall time
+			lastSweep = now;
 		}
+		//how long the last ready event waited for us, see LoadShedder
+		shedder.record(started, monotonicMicros());
 	}
+	//the connections hold timers of this frame's wheel, they go before it does
+	table.destroyClients();
 }
 
 /*
-Accepts a new client connection, creates a new ClientConnection object to manage communication,
-sets up a pollfd struct for the client, and adds it to the poll list.
+Closes, in one pass, every connection whose timer ran out: a header that
+never completed, a body or a response that stopped moving, or a keep-alive
+connection that sent no new request (see ClientConnection::updateTimer).
 */
-void	handleNewClient(ServerSocket* server, std::vector<pollfd> &fds, std::map<int, ClientConnection*>& clients, std::map<int, ServerSocket*>& clientToServer) {
-	int	client_fd = server->acceptClient();
-	if (client_fd == -1) {
-		std::cerr << "❌ Failed to accept client\n";
+void	closeTimedOutConnections(EventBackend& events, ConnectionTable& table,
+			TimerWheel& timers, time_t now) {
+	std::vector<int> expired;
+	timers.advance(now, expired);
+	for (size_t i = 0; i < expired.size(); ++i) {
+		ClientConnection* client = table.client(expired[i]);
+		if (!client)
+			continue;
+		std::cout << "⏱️ " << client->timerName() << " timeout on client " << expired[i] << std::endl;
+		handleClientCleanup(expired[i], events, table);
+	}
+}
+
+/*
+HTTP/1.1 connections stay open unless the client sends "Connection: close",
+HTTP/1.0 ones only when it asks for "Connection: keep-alive".
+keepalive_requests caps how many requests one connection may carry.
+*/
+static bool	shouldKeepAlive(const Request& req, const ServerConfig& config, ClientConnection& client) {
+	int served = client.countRequest();
+	if (config.keepalive_timeout <= 0 || served >= config.keepalive_requests)
+		return false;
+
+	std::string connection = req.getHeader("connection");
+	for (size_t i = 0; i < connection.size(); ++i)
+		connection[i] = std::tolower(static_cast<unsigned char>(connection[i]));
+	if (req.getVersion() == "HTTP/1.1")
+		return connection.find("close") == std::string::npos;
+	return connection.find("keep-alive") != std::string::npos;
+}
+
+/*
+Accepts the waiting client connections (at most MAX_ACCEPTS_PER_WAKEUP, so a
+flood can't starve the clients we already have), creates a ClientConnection
+object for each to manage communication, and registers the client fd
+(edge-triggered) with the event backend. Connections over worker_connections
+or limit_conn_per_ip get a 503 and are closed on the spot.
+*/
+void	handleNewClient(ServerSocket* server, EventBackend& events, ConnectionTable& table,
+			TimerWheel& timers) {
+	//drain the accept queue, a burst costs one wakeup instead of one per connection
+	for (int i = 0; i < MAX_ACCEPTS_PER_WAKEUP; ++i) {
+		sockaddr_in peer;
+		int	client_fd = server->acceptClient(peer);
+		if (client_fd == -1)
+			return;
+		if (!g_admission.admit(client_fd, peer.sin_addr.s_addr)) {
+			rejectConnection(client_fd);
+			continue;
+		}
+		registerClient(client_fd, peer, g_configs.acquire(), server->getHosts(), events, table, timers);
+	}
+}
+
+/*
+Wraps an accepted fd in a ClientConnection, built in a slot of the table,
+watched by this loop's backend. The connection takes over the reference to
+snapshot, the config the listener's hosts belong to.
+*/
+void	registerClient(int client_fd, const sockaddr_in& peer, ConfigSnapshot* snapshot, const VirtualHosts& hosts,
+			EventBackend& events, ConnectionTable& table, TimerWheel& timers) {
+	ClientConnection* client = table.createClient(client_fd, peer, snapshot, hosts, timers);
+	if (!events.add(client_fd, EVENT_READ | EVENT_EDGE)) {
+		table.destroyClient(client_fd);
 		return;
 	}
-	ClientConnection* client = new ClientConnection(client_fd);
-	pollfd client_pfd;
-	client_pfd.fd = client_fd;
-	client_pfd.events = POLLIN;
-	client_pfd.revents = 0;
-	fds.push_back(client_pfd);
-	clients[client_fd] = client;
-	clientToServer[client_fd] = server;
-	std::cout << "A new client has been connected: " << client_fd << std::endl;
+	client->updateTimer(monotonicSeconds()); //client_header_timeout starts now
+	std::cout << "A new client has been connected: " << client_fd << " from "
+		<< client->peerAddress() << ":" << client->peerPort() << std::endl;
 }
 
 /*
-This function finds the corresponding file descriptor in the ClientConnection map,
-parses and handles the HTTP request using the appropriate handler (static, CGI, or upload),
-and then cleans up the client connection.
+This function finds the ClientConnection of the file descriptor in the table,
+reads what the client sent and hands every complete request to serveBufferedRequests.
+Reading stops at a complete request (see recvFullRequest), so once its response
+is out we read again here, or from handleClientWrite if the socket was full.
 */
-void handleExistingClient(int fd, std::vector<pollfd> &fds,
-	std::map<int, ClientConnection*>& clients, size_t& i,
-	const ServerConfig& config)
+void handleExistingClient(int fd, EventBackend& events,
+	ConnectionTable& table, const LoadShedder& shedder)
 {
 
-	std::map<int, ClientConnection*>::iterator it = clients.find(fd);
-	if (it == clients.end()) {
+	ClientConnection* client = table.client(fd);
+	if (!client) {
 		std::cerr << "❌ Unknown client fd: " << fd << std::endl;
 		return;
 	}
+	// Still busy writing earlier responses, the next requests wait in the socket
+	if (client->wantsWrite())
+		return;
 
-	ClientConnection* client = it->second;
-
-	try {
+	do {
 		// Read data from client
-		int bytes = client->recvFullRequest(fd, config);
-		if (bytes <= 0) {
-			handleClientCleanup(fd, fds, clients, i);
+		int bytes = client->recvFullRequest(fd);
+		if (bytes < 0 || (bytes == 0 && client->peerClosed())) {
+			handleClientCleanup(fd, events, table);
+			return;
+		}
+		if (bytes > 0)
+			client->clearIdle();
+
+		// Header over client_max_header_size: the 431 is queued, the connection closes once it is out
+		if (client->getState() == HEADERS_TOO_LARGE) {
+			handleClientWrite(fd, events, table, shedder);
 			return;
 		}
 
 		// Check if request is complete
 		if (!client->isRequestComplete()) {
+			if (client->peerClosed())
+				handleClientCleanup(fd, events, table);
 			return; // Wait for more data
 		}
+		serveBufferedRequests(fd, events, table, shedder);
+		client = table.client(fd); //closed if it was not keep-alive
+	} while (client && !client->wantsWrite() && client->moreToRead());
+}
 
-		std::string request = client->getRawRequest();
-		if (request.empty()) {
-			std::cout << "⚠️ Empty request received" << std::endl;
-			handleClientCleanup(fd, fds, clients, i);
-			return;
+/*
+Handles every complete request sitting in the client's buffer. Pipelined requests
+are answered in order, their responses queue up behind each other, and then we
+start writing. Each one is served by the server block its Host header selected.
+While the loop is overloaded the request gets the preformatted 503 instead,
+without being parsed, and the connection is closed behind it.
+*/
+void serveBufferedRequests(int fd, EventBackend& events,
+	ConnectionTable& table, const LoadShedder& shedder)
+{
+	ClientConnection* client = table.client(fd);
+
+	client->clearIdle();
+	while (client->isRequestComplete()) {
+		if (shedder.shedding()) {
+			client->setKeepAlive(false, 0);
+			client->queueOutput(unavailableResponse());
+			client->consumeRequest();
+			break;
+		}
+		const ServerConfig& config = client->config();
+		try {
+			// the request is parsed in place, nothing is copied out of the buffer
+			Request req(client->requestData(), client->requestLength());
+			processRequest(*client, req, config);
+		} catch (const std::exception& e) {
+			client->setGzip(NULL);
+			std::cerr << "❌ Exception handling client " << fd << ": " << e.what() << std::endl;
+			client->setKeepAlive(false, 0);
+			std::string errorBody = getErrorPageBody(500, config);
+			sendHtmlResponse(*client, 500, errorBody);
 		}
+		client->consumeRequest();
+		// Anything after a 'Connection: close' request is dropped
+		if (!client->keepAlive())
+			break;
+	}
 
-		// Parse request
-		Request req(request);
-		std::string method = req.getMethod();
-		std::string path = req.getPath();
+	// Send what the handlers queued, the connection is closed or reused once it is out
+	handleClientWrite(fd, events, table, shedder);
+}
 
-		std::cout << "📨 " << method << " " << path << std::endl;
+/*
+Queues the response to one parsed request using the appropriate handler
+(static, CGI, or upload).
+*/
+void processRequest(ClientConnection& client, const Request& req, const ServerConfig& config) {
+	std::string method = req.getMethod();
+	std::string path = req.getPath();
+	client.setKeepAlive(shouldKeepAlive(req, config, client), config.keepalive_timeout);
 
-		// URL rewriting for clean URLs - BUT NOT FOR POST UPLOADS
-		std::string actualPath = path;
-		if (method == "GET") {
-			actualPath = rewriteURL(path, config, method);
-			if (actualPath != path) {
-				std::cout << "🔄 URL rewrite: " << path << " → " << actualPath << std::endl;
-				path = actualPath;
-			}
-		} else {
-			// For POST, PUT, DELETE - keep original path
-			std::cout << "📌 Keeping original path for " << method << ": " << path << std::endl;
-		}
-		// std::string actualPath = rewriteURL(path, config);
-		// if (actualPath != path) {
-		// 	std::cout << "🔄 URL rewrite: " << path << " → " << actualPath << std::endl;
-		// 	path = actualPath;
-		// }
-
-		// Find matching location
-		LocationConfig location = matchLocation(path, config);
-
-		// Check if method is allowed in this location
-		bool methodAllowed = false;
-		for (size_t j = 0; j < location.methods.size(); ++j) {
-			if (location.methods[j] == method) {
-				methodAllowed = true;
-				break;
-			}
-		}
+	std::cout << "📨 " << method << " " << path << std::endl;
+
+	// Over limit_req: checked as the headers came in, the body was never stored
+	if (client.rateLimited()) {
+		sendHtmlResponse(client, 429, getErrorPageBody(429, config));
+		return;
+	}
 
-		if (!methodAllowed) {
-			std::cout << "❌ Method " << method << " not allowed for " << path << std::endl;
-			std::string body = getErrorPageBody(405, config); // Method Not Allowed
-			sendHtmlResponse(fd, 405, body);
-			handleClientCleanup(fd, fds, clients, i);
+	// URL rewriting for clean URLs - BUT NOT FOR POST UPLOADS
+	std::string actualPath = path;
+	if (method == "GET") {
+		int status;
+		actualPath = rewriteURL(path, config, status);
+		if (status) {
+			std::cout << "❌ try_files: " << path << " → " << status << std::endl;
+			sendHtmlResponse(client, status, getErrorPageBody(status, config));
 			return;
 		}
+		if (actualPath != path) {
+			std::cout << "🔄 URL rewrite: " << path << " → " << actualPath << std::endl;
+			path = actualPath;
+		}
+	} else {
+		// For POST, PUT, DELETE - keep original path
+		std::cout << "📌 Keeping original path for " << method << ": " << path << std::endl;
+	}
+	// std::string actualPath = rewriteURL(path, config);
+	// if (actualPath != path) {
+	// 	std::cout << "🔄 URL rewrite: " << path << " → " << actualPath << std::endl;
+	// 	path = actualPath;
+	// }
+
+	// Find matching location, a reference into the config: nothing is copied
+	const LocationConfig* match = matchLocation(path, config);
+	if (!match) {
+		std::cout << "❌ No location for " << path << std::endl;
+		sendHtmlResponse(client, 404, getErrorPageBody(404, config));
+		return;
+	}
+	const LocationConfig& location = *match;
+
+	// Check if method is allowed in this location
+	bool methodAllowed = false;
+	for (size_t j = 0; j < location.methods.size(); ++j) {
+		if (location.methods[j] == method) {
+			methodAllowed = true;
+			break;
+		}
+	}
+
+	if (!methodAllowed) {
+		std::cout << "❌ Method " << method << " not allowed for " << path << std::endl;
+		std::string body = getErrorPageBody(405, config); // Method Not Allowed
+		sendHtmlResponse(client, 405, body);
+		return;
+	}
+
+	// Bodies queued by the handlers below may be gzipped for this location
+	if (location.gzip.enabled && acceptsEncoding(req.getHeader("accept-encoding"), "gzip"))
+		client.setGzip(&location.gzip);
 
-		// Handle different HTTP methods with CORRECT parameter order
-		if (method == "GET") {
-			// handleGET(fd, path, location, config)
-			handleGet(fd, path, location, config);
-		} else if (method == "POST") {
-			// handlePOST(fd, req, path, location, config)
-			handlePost(fd, req, path, location, config);
-		} else if (method == "PUT") {
-			// handlePUT(fd, req, path, location, config)
-			handlePut(fd, req, path, location, config);
-		} else if (method == "DELETE") {
-			// handleDELETE(fd, path, location, config)
-			handleDelete(fd, path, location, config);
-		} else if (method == "HEAD") {
-			// handleHEAD(fd, path, location, config)
-			handleHead(fd, path, location, config);
-		} else {
-			std::cout << "❌ Method " << method << " not implemented" << std::endl;
-			std::string body = getErrorPageBody(501, config); // Not Implemented
-			sendHtmlResponse(fd, 501, body);
-		}
-
-	} catch (const std::exception& e) {
-		std::cerr << "❌ Exception handling client " << fd << ": " << e.what() << std::endl;
-		std::string errorBody = getErrorPageBody(500, config);
-		sendHtmlResponse(fd, 500, errorBody);
-	}
-
-	// Clean up client connection
-	handleClientCleanup(fd, fds, clients, i);
+	// Handle different HTTP methods with CORRECT parameter order
+	if (method == "GET") {
+		// handleGET(fd, req, path, location, config)
+		handleGet(client, req, path, location, config);
+	} else if (method == "POST") {
+		// handlePOST(fd, req, path, location, config)
+		handlePost(client, req, path, location, config);
+	} else if (method == "PUT") {
+		// handlePUT(fd, req, path, location, config)
+		handlePut(client, req, path, location, config);
+	} else if (method == "DELETE") {
+		// handleDELETE(fd, path, location, config)
+		handleDelete(client, path, location, config);
+	} else if (method == "HEAD") {
+		// handleHEAD(fd, req, path, location, config)
+		handleHead(client, req, path, location, config);
+	} else {
+		std::cout << "❌ Method " << method << " not implemented" << std::endl;
+		std::string body = getErrorPageBody(501, config); // Not Implemented
+		sendHtmlResponse(client, 501, body);
+	}
+	client.setGzip(NULL);
+}
+
+/*
+Writes out whatever the client has queued. If the socket is full we switch the fd
+to write events and come back here when it drains, so a slow download never blocks
+the loop. Once everything is sent a keep-alive connection goes back to its next
+request, any other connection is closed.
+*/
+void handleClientWrite(int fd, EventBackend& events, ConnectionTable& table,
+	const LoadShedder& shedder) {
+	ClientConnection* client = table.client(fd);
+	if (!client)
+		return;
+
+	int status = client->flushOutput();
+	if (status > 0) {
+		if (!client->wantsWrite()) {
+			events.modify(fd, EVENT_WRITE | EVENT_EDGE);
+			client->setWantWrite(true);
+		}
+		return;
+	}
+	if (status == 0 && client->keepAlive() && !client->peerClosed()) {
+		client->resetRequest();
+		bool drained = client->wantsWrite();
+		if (drained) {
+			events.modify(fd, EVENT_READ | EVENT_EDGE);
+			client->setWantWrite(false);
+		}
+		//pipelined requests that arrived while we were writing
+		if (client->isRequestComplete())
+			serveBufferedRequests(fd, events, table, shedder);
+		//and the ones left in the socket, only from a write event: when serving
+		//queued this response, handleExistingClient's own loop reads them
+		client = table.client(fd);
+		if (drained && client && !client->wantsWrite() && client->moreToRead())
+			handleExistingClient(fd, events, table, shedder);
+		return;
+	}
+	handleClientCleanup(fd, events, table);
 }
\ No newline at end of file
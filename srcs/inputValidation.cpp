@@ -44,10 +44,16 @@ Parses each 'listen' entry from the server block and extracts host and port valu
 If the entry is in the form 'host:port', it sets the server's host and port accordingly.
 If no host is specified, it assumes the entry is just a port.
 Validates each port, and if valid, adds it to the server's ports vector.
+'listen 127.0.0.1:8081 default_server' also makes this block the one that
+answers requests whose Host header matches no server_name on that port, the
+other parameters are socket options (see ListenOptions).
 */
 void	convertListenEntriesToPortsAndHost(ServerConfig& server) {
 	for (size_t i = 0; i < server.listen_entries.size(); ++i) {
-		const std::string& entry = server.listen_entries[i];
+		std::vector<std::string> params = line_splitter(server.listen_entries[i]);
+		if (params.empty())
+			continue;
+		const std::string& entry = params[0];
 		size_t colon = entry.find(':');
 		std::string portString;
 		if (colon == std::string::npos) //no colon found
@@ -61,28 +67,47 @@ void	convertListenEntriesToPortsAndHost(ServerConfig& server) {
 			std::cerr << "⚠️ Invalid port in listen directive: " << entry << std::endl;
 			continue;
 		}
-		server.ports.push_back(std::atoi(portString.c_str()));
+		int port = std::atoi(portString.c_str());
+		server.ports.push_back(port);
+		//only socket options create an entry, default_server is not one of them
+		for (size_t j = 1; j < params.size(); ++j) {
+			if (params[j] == "default_server")
+				server.default_ports.push_back(port);
+			else if (params[j].compare(0, 8, "backlog=") == 0)
+				server.listen_options[port].backlog = std::atoi(params[j].c_str() + 8);
+			else if (params[j] == "deferred")
+				server.listen_options[port].deferred = true;
+			else if (params[j].compare(0, 9, "fastopen=") == 0)
+				server.listen_options[port].fastopen = std::atoi(params[j].c_str() + 9);
+			else if (params[j] == "reuseport")
+				server.listen_options[port].reuseport = true;
+			else
+				std::cerr << "⚠️ Unknown listen parameter: " << params[j] << std::endl;
+		}
 	}
 }
 
 /*
-We must check that there are no duplicate host:port pairs as this will
-cause a bind() error.
+Server blocks may share a host:port, one socket is opened for it and the Host
+header picks the block (see VirtualHosts). What is still wrong:
 
-Valid (different server blocks):
-listen 127.0.0.1:8080 and listen 127.0.0.1:8081,
-listen 127.0.0.1:8081 and listen 192.168.1.1:8081
+Not valid (same server block):
+listen 127.0.0.1:8080 and listen 127.0.0.1:8080, bind() would fail
 
 Not valid (different server blocks):
-listen 127.0.0.1:8080 and listen 127.0.0.1:8080
+listen 127.0.0.1:8080 default_server twice, only one can be the fallback
+listen 127.0.0.1:8080 backlog=64 and listen 127.0.0.1:8080 backlog=128, there is
+one socket, so the blocks that give socket options must give the same ones
 
-This function parses through all of the servers listed to check for duplicate pairs
+This function parses through all of the servers listed to check for these
 */
 void checkDuplicateHostPortPairs(const std::vector<ServerConfig>& servers) {
-	std::set<std::string> seen;
+	std::set<std::string> defaults;
+	std::map<std::string, ListenOptions> options; //per host:port, from the first block that gave any
 
 	for (size_t i = 0; i < servers.size(); ++i) {
 		const std::string& host = servers[i].host;
+		std::set<std::string> seen;
 		for (size_t j = 0; j < servers[i].ports.size(); ++j) {
 			int port = servers[i].ports[j];
 			std::ostringstream oss;
@@ -93,6 +118,20 @@ void checkDuplicateHostPortPairs(const std::vector<ServerConfig>& servers) {
 				throw std::runtime_error("❌ Duplicate Host Port pair found\n");
 			}
 			seen.insert(key);
+			std::map<int, ListenOptions>::const_iterator given = servers[i].listen_options.find(port);
+			if (given != servers[i].listen_options.end()) {
+				std::map<std::string, ListenOptions>::iterator first = options.find(key);
+				if (first == options.end())
+					options[key] = given->second;
+				else if (!(first->second == given->second))
+					throw std::runtime_error("❌ Conflicting listen options for " + key + "\n");
+			}
+			if (std::find(servers[i].default_ports.begin(), servers[i].default_ports.end(), port)
+				== servers[i].default_ports.end())
+				continue;
+			if (defaults.count(key))
+				throw std::runtime_error("❌ Duplicate default_server for " + key + "\n");
+			defaults.insert(key);
 		}
 	}
-}
\ No newline at end of file
+}
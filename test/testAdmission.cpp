@@ -0,0 +1,101 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   testAdmission.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "testUnit.hpp"
+
+static void	configure(AdmissionControl& admission, size_t connections, int perIp) {
+	GlobalConfig global;
+	global.worker_connections = connections;
+	global.limit_conn_per_ip = perIp;
+	admission.configure(global);
+}
+
+static void	testLimits() {
+	AdmissionControl admission;
+	in_addr_t first = inet_addr("10.0.0.1");
+	in_addr_t second = inet_addr("10.0.0.2");
+	in_addr_t third = inet_addr("10.0.0.3");
+
+	configure(admission, 3, 2);
+	CHECK(admission.admit(5, first));
+	CHECK(admission.admit(6, first));
+	CHECK(!admission.admit(7, first)); //limit_conn_per_ip
+	CHECK(admission.admit(8, second));
+	CHECK(!admission.admit(9, third)); //worker_connections
+	CHECK(admission.active() == 3);
+
+	admission.release(5);
+	admission.release(5); //a second release of the same fd is a no-op
+	admission.release(1000); //so is one that was never admitted
+	CHECK(admission.active() == 2);
+	CHECK(admission.admit(5, first));
+	CHECK(!admission.admit(9, first));
+	admission.release(5);
+	admission.release(6);
+	admission.release(8);
+	CHECK(admission.active() == 0);
+}
+
+//with limit_conn_per_ip off nothing is counted per address, a reload turning
+//it on or off releases exactly what each connection took
+static void	testReload() {
+	AdmissionControl admission;
+	in_addr_t ip = inet_addr("10.0.0.1");
+
+	configure(admission, 0, 0);
+	for (int fd = 3; fd < 103; ++fd)
+		CHECK(admission.admit(fd, ip));
+	configure(admission, 0, 1);
+	CHECK(admission.admit(200, ip)); //the 100 above were not counted
+	CHECK(!admission.admit(201, ip));
+	for (int fd = 3; fd < 103; ++fd)
+		admission.release(fd);
+	CHECK(!admission.admit(201, ip)); //fd 200 still holds the only place
+	configure(admission, 0, 0);
+	admission.release(200);
+	configure(admission, 0, 1);
+	CHECK(admission.admit(201, ip));
+	admission.release(201);
+	CHECK(admission.active() == 0);
+}
+
+//passes are (started, finished) in microseconds, target 10ms, interval 100ms
+static void	testShedder() {
+	LoadShedder shedder(10, 100);
+	long now = 1000000;
+
+	shedder.record(now, now + 5000);
+	CHECK(!shedder.shedding());
+	now += 20000;
+	shedder.record(now - 20000, now); //first slow pass starts the clock
+	CHECK(!shedder.shedding());
+	now += 50000;
+	shedder.record(now - 20000, now);
+	CHECK(!shedder.shedding()); //not slow for a whole interval yet
+	now += 60000;
+	shedder.record(now - 20000, now);
+	CHECK(shedder.shedding());
+	now += 1000;
+	shedder.record(now - 1000, now); //one fast pass is enough to serve again
+	CHECK(!shedder.shedding());
+
+	LoadShedder never(0, 100);
+	never.record(0, 10000000);
+	CHECK(!never.shedding());
+}
+
+int	main() {
+	testLimits();
+	testReload();
+	testShedder();
+	return testResult("admission control");
+}
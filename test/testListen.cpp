@@ -0,0 +1,110 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   testListen.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "testUnit.hpp"
+
+static ServerConfig	listening(const std::string& entry) {
+	ServerConfig server;
+	server.listen_entries.push_back(entry);
+	convertListenEntriesToPortsAndHost(server);
+	return server;
+}
+
+//what a listen line turns into in one server block
+static void	testEntries() {
+	ServerConfig plain = listening("127.0.0.1:7001");
+	CHECK(plain.host == "127.0.0.1" && plain.ports.size() == 1 && plain.ports[0] == 7001);
+	CHECK(plain.default_ports.empty() && plain.listen_options.empty());
+
+	ServerConfig fallback = listening("7002 default_server");
+	CHECK(fallback.ports.size() == 1 && fallback.ports[0] == 7002);
+	CHECK(fallback.default_ports.size() == 1 && fallback.default_ports[0] == 7002);
+	CHECK(fallback.listen_options.empty()); //default_server is not a socket option
+
+	ServerConfig tuned = listening("127.0.0.1:7003 default_server backlog=64 deferred fastopen=16 reuseport");
+	CHECK(tuned.listen_options.count(7003) == 1);
+	const ListenOptions& options = tuned.listen_options[7003];
+	CHECK(options.backlog == 64 && options.deferred && options.fastopen == 16 && options.reuseport);
+	CHECK(tuned.default_ports.size() == 1);
+
+	CHECK(listening("127.0.0.1:http").ports.empty());
+	CHECK(listening("80").ports.empty());
+}
+
+//blocks sharing a host:port share one socket
+static void	testSharedAddresses() {
+	std::vector<ServerConfig> servers;
+	servers.push_back(listening("127.0.0.1:7010 backlog=64"));
+	servers.push_back(listening("127.0.0.1:7010 default_server"));
+	checkDuplicateHostPortPairs(servers);
+
+	servers.push_back(listening("127.0.0.1:7010 backlog=64"));
+	checkDuplicateHostPortPairs(servers); //the same options again are fine
+
+	servers.push_back(listening("127.0.0.1:7010 backlog=128"));
+	THROWS(checkDuplicateHostPortPairs(servers));
+
+	servers.clear();
+	servers.push_back(listening("127.0.0.1:7011 default_server"));
+	servers.push_back(listening("127.0.0.1:7011 default_server"));
+	THROWS(checkDuplicateHostPortPairs(servers));
+
+	ServerConfig twice;
+	twice.listen_entries.push_back("127.0.0.1:7012");
+	twice.listen_entries.push_back("127.0.0.1:7012");
+	convertListenEntriesToPortsAndHost(twice);
+	servers.clear();
+	servers.push_back(twice);
+	THROWS(checkDuplicateHostPortPairs(servers));
+}
+
+//a block that only adds default_server keeps the options of an earlier one
+static void	testSnapshot() {
+	char path[] = "/tmp/webserv_listen_XXXXXX";
+	int fd = mkstemp(path);
+	CHECK(fd != -1);
+	std::string config =
+		"http {\n"
+		"\tserver {\n"
+		"\t\tlisten 127.0.0.1:7020 backlog=64 deferred;\n"
+		"\t\tserver_name a;\n"
+		"\t\troot /tmp;\n"
+		"\t}\n"
+		"\tserver {\n"
+		"\t\tlisten 127.0.0.1:7020 default_server;\n"
+		"\t\tserver_name b;\n"
+		"\t\troot /tmp;\n"
+		"\t}\n"
+		"}\n";
+	CHECK(write(fd, config.data(), config.size()) == static_cast<ssize_t>(config.size()));
+	close(fd);
+
+	ConfigParser parser;
+	parser.parseFile(path);
+	unlink(path);
+	checkDuplicateHostPortPairs(parser.getServers());
+	ConfigSnapshot* snapshot = new ConfigSnapshot(parser, 1);
+	const std::map<std::string, ListenAddress>& addresses = snapshot->addresses();
+	CHECK(addresses.size() == 1 && addresses.count("127.0.0.1:7020"));
+	if (addresses.count("127.0.0.1:7020")) {
+		const ListenOptions& options = addresses.find("127.0.0.1:7020")->second.options;
+		CHECK(options.backlog == 64 && options.deferred && !options.reuseport);
+	}
+	snapshot->release();
+}
+
+int	main() {
+	testEntries();
+	testSharedAddresses();
+	testSnapshot();
+	return testResult("listen options");
+}
@@ -0,0 +1,63 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   testRanges.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "testUnit.hpp"
+
+static bool	isRange(const ByteRange& range, off_t first, off_t last) {
+	return range.first == first && range.last == last;
+}
+
+int	main() {
+	std::vector<ByteRange> ranges;
+
+	//first-last, open ended and suffix ranges of a 1000 byte file
+	CHECK(parseRangeHeader("bytes=0-99", 1000, ranges) == RANGE_SATISFIABLE);
+	CHECK(ranges.size() == 1 && isRange(ranges[0], 0, 99) && ranges[0].length() == 100);
+	CHECK(parseRangeHeader("bytes=900-", 1000, ranges) == RANGE_SATISFIABLE);
+	CHECK(ranges.size() == 1 && isRange(ranges[0], 900, 999));
+	CHECK(parseRangeHeader("bytes=-100", 1000, ranges) == RANGE_SATISFIABLE);
+	CHECK(ranges.size() == 1 && isRange(ranges[0], 900, 999));
+	CHECK(parseRangeHeader("bytes=-5000", 1000, ranges) == RANGE_SATISFIABLE);
+	CHECK(ranges.size() == 1 && isRange(ranges[0], 0, 999));
+
+	//the end is clamped to the file, several ranges keep their order
+	CHECK(parseRangeHeader("bytes=500-5000", 1000, ranges) == RANGE_SATISFIABLE);
+	CHECK(ranges.size() == 1 && isRange(ranges[0], 500, 999));
+	CHECK(parseRangeHeader("bytes=0-1, 10-19,-1", 1000, ranges) == RANGE_SATISFIABLE);
+	CHECK(ranges.size() == 3 && isRange(ranges[0], 0, 1) && isRange(ranges[1], 10, 19)
+		&& isRange(ranges[2], 999, 999));
+
+	//ranges past the end are dropped, none left is a 416
+	CHECK(parseRangeHeader("bytes=1000-", 1000, ranges) == RANGE_NOT_SATISFIABLE);
+	CHECK(parseRangeHeader("bytes=2000-2100, 0-0", 1000, ranges) == RANGE_SATISFIABLE);
+	CHECK(ranges.size() == 1 && isRange(ranges[0], 0, 0));
+	CHECK(parseRangeHeader("bytes=-0", 1000, ranges) == RANGE_NOT_SATISFIABLE);
+	CHECK(parseRangeHeader("bytes=0-10", 0, ranges) == RANGE_NOT_SATISFIABLE);
+
+	//anything malformed sends the whole file with a 200
+	CHECK(parseRangeHeader("", 1000, ranges) == RANGE_IGNORED);
+	CHECK(parseRangeHeader("items=0-1", 1000, ranges) == RANGE_IGNORED);
+	CHECK(parseRangeHeader("bytes=", 1000, ranges) == RANGE_IGNORED);
+	CHECK(parseRangeHeader("bytes=5", 1000, ranges) == RANGE_IGNORED);
+	CHECK(parseRangeHeader("bytes=10-5", 1000, ranges) == RANGE_IGNORED);
+	CHECK(parseRangeHeader("bytes=a-5", 1000, ranges) == RANGE_IGNORED);
+	CHECK(parseRangeHeader("bytes=0-1,x", 1000, ranges) == RANGE_IGNORED);
+
+	//more than 16 ranges is treated as abuse
+	std::string many = "bytes=0-0";
+	for (int i = 1; i < 16; ++i)
+		many += "," + intToStr(i * 2) + "-" + intToStr(i * 2);
+	CHECK(parseRangeHeader(many, 1000, ranges) == RANGE_SATISFIABLE && ranges.size() == 16);
+	CHECK(parseRangeHeader(many + ",40-40", 1000, ranges) == RANGE_IGNORED);
+
+	return testResult("parseRangeHeader");
+}
@@ -0,0 +1,155 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   testRateLimit.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "testUnit.hpp"
+
+//one token bucket per address, times in ms
+static void	testZone() {
+	LimitReqZoneSpec spec; //1r/s
+	RateLimitZone zone(spec);
+	in_addr_t first = inet_addr("10.0.0.1");
+	in_addr_t second = inet_addr("10.0.0.2");
+
+	CHECK(zone.allow(first, 0, 1000));
+	CHECK(!zone.allow(first, 0, 1500));
+	CHECK(zone.allow(second, 0, 1500)); //every address has its own bucket
+	CHECK(zone.allow(first, 0, 2000));
+
+	//burst=2 lets three through at once, then one per second
+	CHECK(zone.allow(first, 2, 10000));
+	CHECK(zone.allow(first, 2, 10000));
+	CHECK(zone.allow(first, 2, 10000));
+	CHECK(!zone.allow(first, 2, 10000));
+	CHECK(zone.allow(first, 2, 11000));
+	CHECK(!zone.allow(first, 2, 11000));
+
+	//1r/m, the rate in thousandths keeps it from rounding to zero
+	spec.rate = 1000 / 60;
+	RateLimitZone slow(spec);
+	CHECK(slow.allow(first, 0, 1000));
+	CHECK(!slow.allow(first, 0, 31000));
+	CHECK(slow.allow(first, 0, 64000));
+}
+
+//a table smaller than the number of clients recycles the idlest buckets
+static void	testRecycling() {
+	LimitReqZoneSpec spec;
+	spec.size = 1;
+	RateLimitZone zone(spec);
+	CHECK(zone.slots() == 8);
+	bool allAllowed = true;
+	for (int i = 0; i < 100; ++i)
+		allAllowed = allAllowed && zone.allow(htonl(0x0a000000 + i), 0, 1000 + i);
+	CHECK(allAllowed);
+	in_addr_t recent = htonl(0x0a000000 + 99);
+	CHECK(!zone.allow(recent, 0, 1100)); //still remembered
+}
+
+static void	testDirectives() {
+	ConfigParser	parser;
+	LimitReqPolicy	policy;
+
+	CHECK(parser.parseLimitReq(policy, "limit_req", "zone=api burst=5 nodelay"));
+	CHECK(policy.zone == "api" && policy.burst == 5);
+	CHECK(!parser.parseLimitReq(policy, "limit_rate", "10k"));
+	THROWS(parser.parseLimitReq(policy, "limit_req", "burst=5"));
+	THROWS(parser.parseLimitReq(policy, "limit_req", "zone=api burst=-1"));
+	THROWS(parser.parseLimitReq(policy, "limit_req", "zone=api burst=5x"));
+	THROWS(parser.parseLimitReq(policy, "limit_req", "zone=api delay=3"));
+
+	parser.parseGlobalDirective("limit_req_zone", "$binary_remote_addr zone=api:64k rate=10r/s");
+	parser.parseGlobalDirective("limit_req_zone", "zone=slow:1m rate=6r/m");
+	const std::map<std::string, LimitReqZoneSpec>& zones = parser.getGlobal().limit_req_zones;
+	CHECK(zones.size() == 2);
+	CHECK(zones.count("api") && zones.find("api")->second.rate == 10000
+		&& zones.find("api")->second.size == 64 * 1024);
+	CHECK(zones.count("slow") && zones.find("slow")->second.rate == 100);
+	THROWS(parser.parseGlobalDirective("limit_req_zone", "zone=bad:1m rate=10r/h"));
+	THROWS(parser.parseGlobalDirective("limit_req_zone", "zone=bad:1m rate=0r/s"));
+	THROWS(parser.parseGlobalDirective("limit_req_zone", "$cookie zone=bad:1m rate=1r/s"));
+	THROWS(parser.parseGlobalDirective("limit_req_zone", "rate=1r/s"));
+}
+
+/*
+The limit is checked as soon as a request's headers are in: an upload over it
+never opens a stream, its body is dropped and processRequest answers 429.
+*/
+static void	testConnection() {
+	char path[] = "/tmp/webserv_limit_XXXXXX";
+	int fd = mkstemp(path);
+	char root[] = "/tmp/webserv_limit_root_XXXXXX";
+	CHECK(fd != -1 && mkdtemp(root) != NULL);
+	std::string config = std::string(
+		"limit_req_zone zone=uploads:1m rate=1r/m;\n"
+		"server {\n"
+		"\tlisten 127.0.0.1:7030;\n"
+		"\troot ") + root + ";\n"
+		"\tlocation / {\n"
+		"\t\tallowed_methods GET POST;\n"
+		"\t}\n"
+		"\tlocation /upload {\n"
+		"\t\tallowed_methods POST;\n"
+		"\t\tlimit_req zone=uploads;\n"
+		"\t}\n"
+		"}\n";
+	CHECK(write(fd, config.data(), config.size()) == static_cast<ssize_t>(config.size()));
+	close(fd);
+	ConfigParser parser;
+	parser.parseFile(path);
+	unlink(path);
+	g_requestLimiter.configure(parser.getGlobal().limit_req_zones);
+	CHECK(g_requestLimiter.enabled());
+	ConfigSnapshot* snapshot = new ConfigSnapshot(parser, 1);
+	const VirtualHosts* hosts = snapshot->hosts("127.0.0.1:7030");
+	CHECK(hosts != NULL);
+	if (!hosts) {
+		snapshot->release();
+		return;
+	}
+
+	std::string body = "--b\r\nContent-Disposition: form-data; name=\"file\"; filename=\"a.txt\"\r\n\r\nhello\r\n--b--\r\n";
+	std::string upload = "POST /upload HTTP/1.1\r\nHost: x\r\nContent-Type: multipart/form-data; boundary=b\r\n"
+		"Content-Length: " + intToStr(static_cast<int>(body.size())) + "\r\n\r\n" + body;
+	sockaddr_in peer;
+	std::memset(&peer, 0, sizeof(peer));
+	peer.sin_family = AF_INET;
+	peer.sin_addr.s_addr = inet_addr("10.0.0.9");
+	TimerWheel timers(time(NULL));
+	bool limited[2];
+	for (int i = 0; i < 2; ++i) {
+		int pair[2];
+		CHECK(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) == 0);
+		snapshot->retain();
+		ClientConnection client(pair[0], peer, snapshot, *hosts, timers);
+		CHECK(send(pair[1], upload.data(), upload.size(), 0) == static_cast<ssize_t>(upload.size()));
+		client.recvFullRequest(pair[0]);
+		CHECK(client.isRequestComplete());
+		limited[i] = client.rateLimited();
+		CHECK(limited[i] == (client.getUpload() == NULL));
+		CHECK(!limited[i] || client.requestLength() < upload.size()); //the body was not kept
+		close(pair[1]);
+	}
+	CHECK(!limited[0] && limited[1]);
+	snapshot->release();
+	std::string uploads = std::string(root) + "/upload";
+	unlink((uploads + "/a.txt").c_str()); //the first, allowed upload
+	rmdir(uploads.c_str());
+	rmdir(root);
+}
+
+int	main() {
+	testZone();
+	testRecycling();
+	testDirectives();
+	testConnection();
+	return testResult("limit_req");
+}
@@ -0,0 +1,87 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   testRewrite.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "testUnit.hpp"
+
+//rewrite and try_files lines as the config parser hands them over
+static void	testDirectives() {
+	ConfigParser	parser;
+	RewriteEngine	rewrites;
+
+	CHECK(parser.parseRewrite(rewrites, "rewrite", "^/home$ /index.html"));
+	CHECK(parser.parseRewrite(rewrites, "rewrite", "^/img/(.*)\\.png$ /images/$1.png"));
+	CHECK(parser.parseRewrite(rewrites, "try_files", "$uri $uri.html =404"));
+	CHECK(parser.parseRewrite(rewrites, "try_files_cache_valid", "5s"));
+	CHECK(!parser.parseRewrite(rewrites, "root", "www"));
+
+	THROWS(parser.parseRewrite(rewrites, "rewrite", "^/home$"));
+	THROWS(parser.parseRewrite(rewrites, "rewrite", "^/a$ /b /c"));
+	THROWS(parser.parseRewrite(rewrites, "try_files", "$uri"));
+	THROWS(parser.parseRewrite(rewrites, "try_files", "$uri ="));
+	THROWS(parser.parseRewrite(rewrites, "try_files", "$uri =abc"));
+	THROWS(parser.parseRewrite(rewrites, "try_files", "$uri =404x"));
+	THROWS(parser.parseRewrite(rewrites, "try_files", "$uri =200"));
+	THROWS(parser.parseRewrite(rewrites, "try_files", "$uri =600"));
+	CHECK(parser.parseRewrite(rewrites, "try_files", "$uri =301"));
+
+	rewrites.compile();
+	CHECK(rewrites.rewrite("/home") == "/index.html");
+	CHECK(rewrites.rewrite("/home/") == "/home/");
+	CHECK(rewrites.rewrite("/img/cat.png") == "/images/cat.png");
+	CHECK(rewrites.rewrite("/img/cat.jpg") == "/img/cat.jpg");
+}
+
+static void	touch(const std::string& path) {
+	std::ofstream file(path.c_str());
+	file << "x";
+}
+
+//the probe cache remembers misses until a write to a file it could resolve to
+static void	testProbes() {
+	char dir[] = "/tmp/webserv_rewrite_XXXXXX";
+	CHECK(mkdtemp(dir) != NULL);
+	std::string root = dir;
+	ConfigParser	parser;
+	RewriteEngine	rewrites;
+	FileCachePolicy	cache;
+	int				status;
+
+	parser.parseRewrite(rewrites, "try_files", "$uri $uri.html =404");
+	parser.parseRewrite(rewrites, "try_files_cache_valid", "60s");
+	rewrites.compile();
+
+	CHECK(rewrites.tryFiles("/page", root, cache, status) == "/page" && status == 404);
+	touch(root + "/page.html");
+	CHECK(rewrites.tryFiles("/page", root, cache, status) == "/page" && status == 404); //still the cached miss
+	rewrites.invalidate(root + "/page.html", root);
+	CHECK(rewrites.tryFiles("/page", root, cache, status) == "/page.html" && status == 0);
+
+	//another file under the root leaves the probe alone
+	touch(root + "/page");
+	rewrites.invalidate(root + "/other", root);
+	CHECK(rewrites.tryFiles("/page", root, cache, status) == "/page.html");
+	rewrites.invalidate(root + "/page", root);
+	CHECK(rewrites.tryFiles("/page", root, cache, status) == "/page");
+
+	//a path outside the root can't be mapped back to a URI, everything goes
+	unlink((root + "/page").c_str());
+	unlink((root + "/page.html").c_str());
+	rewrites.invalidate("/elsewhere/page", root);
+	CHECK(rewrites.tryFiles("/page", root, cache, status) == "/page" && status == 404);
+	rmdir(dir);
+}
+
+int	main() {
+	testDirectives();
+	testProbes();
+	return testResult("rewrite and try_files");
+}
@@ -0,0 +1,134 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   testTimerWheel.cpp                                 :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "testUnit.hpp"
+
+//runs the wheel to now and returns the fds that fired, sorted
+static std::vector<int>	fired(TimerWheel& wheel, time_t now) {
+	std::vector<int> expired;
+	wheel.advance(now, expired);
+	std::sort(expired.begin(), expired.end());
+	return expired;
+}
+
+static void	testLevelZero() {
+	TimerWheel	wheel(1000);
+	TimerHandle	a(3);
+	TimerHandle	b(4);
+	TimerHandle	c(5);
+
+	wheel.schedule(a, 1005);
+	wheel.schedule(b, 1005);
+	wheel.schedule(c, 1010);
+	CHECK(wheel.size() == 3 && a.armed());
+	CHECK(fired(wheel, 1004).empty());
+	std::vector<int> due = fired(wheel, 1005);
+	CHECK(due.size() == 2 && due[0] == 3 && due[1] == 4);
+	CHECK(!a.armed() && !b.armed() && c.armed() && wheel.size() == 1);
+
+	//re-arming moves the timer, cancelling takes it out
+	wheel.schedule(c, 1020);
+	CHECK(fired(wheel, 1015).empty());
+	wheel.cancel(c);
+	wheel.cancel(c);
+	CHECK(!c.armed() && wheel.size() == 0);
+	CHECK(fired(wheel, 1030).empty());
+
+	//an expiry in the past fires on the next tick
+	wheel.schedule(a, 900);
+	CHECK(fired(wheel, 1031).size() == 1);
+}
+
+//the middle of a slot's list can go without disturbing its neighbours
+static void	testUnlink() {
+	TimerWheel	wheel(0);
+	std::vector<TimerHandle> timers;
+	for (int fd = 0; fd < 5; ++fd)
+		timers.push_back(TimerHandle(fd));
+	for (size_t i = 0; i < timers.size(); ++i)
+		wheel.schedule(timers[i], 7);
+	wheel.cancel(timers[2]);
+	wheel.cancel(timers[0]);
+	wheel.cancel(timers[4]);
+	std::vector<int> due = fired(wheel, 7);
+	CHECK(due.size() == 2 && due[0] == 1 && due[1] == 3);
+	CHECK(wheel.size() == 0);
+}
+
+//timers beyond the first level cascade down and still fire on their second
+static void	testCascade() {
+	TimerWheel	wheel(100);
+	TimerHandle	minutes(1);
+	TimerHandle	hours(2);
+	TimerHandle	days(3);
+
+	wheel.schedule(minutes, 100 + 200);
+	wheel.schedule(hours, 100 + 5000);
+	wheel.schedule(days, 100 + 90000);
+	CHECK(fired(wheel, 299).empty());
+	CHECK(fired(wheel, 300) == std::vector<int>(1, 1));
+	CHECK(fired(wheel, 5099).empty());
+	CHECK(fired(wheel, 5100) == std::vector<int>(1, 2));
+	CHECK(fired(wheel, 90099).empty() && days.armed());
+	CHECK(fired(wheel, 90100) == std::vector<int>(1, 3));
+	CHECK(wheel.size() == 0);
+}
+
+//many timers spread over every level all fire exactly once, at their time
+static void	testMany() {
+	TimerWheel	wheel(0);
+	std::vector<TimerHandle> timers;
+	for (int fd = 0; fd < 2000; ++fd)
+		timers.push_back(TimerHandle(fd));
+	for (size_t i = 0; i < timers.size(); ++i)
+		wheel.schedule(timers[i], 1 + (i * 37) % 10000);
+	size_t count = 0;
+	bool onTime = true;
+	for (time_t now = 1; now <= 10000; ++now) {
+		std::vector<int> due = fired(wheel, now);
+		for (size_t i = 0; i < due.size(); ++i)
+			onTime = onTime && timers[due[i]].expires == now;
+		count += due.size();
+	}
+	CHECK(count == timers.size() && onTime && wheel.size() == 0);
+}
+
+//the timeouts that arm these timers accept nginx's units and nothing else
+static void	testTimeouts() {
+	ConfigParser	parser;
+	ServerConfig	server;
+
+	parser.parseServerDirective(server, "client_header_timeout", "1m");
+	parser.parseServerDirective(server, "client_body_timeout", "30s");
+	parser.parseServerDirective(server, "send_timeout", "90");
+	CHECK(server.client_header_timeout == 60 && server.client_body_timeout == 30 && server.send_timeout == 90);
+	parser.parseServerDirective(server, "send_timeout", "1h");
+	CHECK(server.send_timeout == 3600);
+	parser.parseServerDirective(server, "keepalive_timeout", "2m");
+	CHECK(server.keepalive_timeout == 120);
+	parser.parseServerDirective(server, "keepalive_timeout", "0");
+	CHECK(server.keepalive_timeout == 0);
+	THROWS(parser.parseServerDirective(server, "keepalive_timeout", "15 s"));
+	THROWS(parser.parseServerDirective(server, "client_header_timeout", "1x"));
+	THROWS(parser.parseServerDirective(server, "client_body_timeout", "-5"));
+	THROWS(parser.parseServerDirective(server, "send_timeout", "m"));
+	THROWS(parser.parseServerDirective(server, "send_timeout", "10ss"));
+}
+
+int	main() {
+	testTimeouts();
+	testLevelZero();
+	testUnlink();
+	testCascade();
+	testMany();
+	return testResult("timer wheel");
+}
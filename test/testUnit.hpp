@@ -0,0 +1,70 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   testUnit.hpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: kellen <kellen@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:41 by kellen            #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:41 by kellen           ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef TESTUNIT_HPP
+#define TESTUNIT_HPP
+
+#include <iostream>
+
+#include "WebServ.hpp"
+
+/*
+Shared by the unit tests in this folder (make test_units). Each one links the
+server sources except WebServ.cpp, so the few globals that live there are
+defined here. Include it from exactly one file per test program.
+*/
+volatile sig_atomic_t g_signal = 1;
+volatile sig_atomic_t g_reload = 0;
+
+void	applyGlobalConfig(const GlobalConfig& global) {
+	(void)global;
+}
+
+int		serveWebserv(const ConfigParser& parser, bool reusePort) {
+	(void)parser;
+	(void)reusePort;
+	return 0;
+}
+
+static int g_failures = 0;
+
+//keeps going after a failure so one run reports every broken case
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::cerr << "❌ " << __FILE__ << ":" << __LINE__ << ": " << #condition << std::endl; \
+			++g_failures; \
+		} \
+	} while (0)
+
+//true when the statement throws std::runtime_error, like the config parser does
+#define THROWS(statement) \
+	do { \
+		bool thrown = false; \
+		try { statement; } \
+		catch (const std::runtime_error&) { thrown = true; } \
+		if (!thrown) { \
+			std::cerr << "❌ " << __FILE__ << ":" << __LINE__ << ": no exception from " << #statement << std::endl; \
+			++g_failures; \
+		} \
+	} while (0)
+
+static int	testResult(const char* name) {
+	if (g_failures) {
+		std::cerr << "❌ " << name << ": " << g_failures << " failed" << std::endl;
+		return 1;
+	}
+	std::cout << "✅ " << name << std::endl;
+	return 0;
+}
+
+#endif // TESTUNIT_HPP